@@ -0,0 +1,34 @@
+#version 330
+#ifdef GL_ARB_gpu_shader5
+#extension GL_ARB_gpu_shader5 : enable
+#define PRECISE precise
+#else
+#define PRECISE
+#endif
+
+#include "counter_rng.glsl"
+
+// One chain of the parallel chaos game per vertex, advanced by uSteps steps
+// from counter uCounter and captured by transform feedback: vPosition as the
+// point drawn, vState as where the chain goes on from at the next step.
+in vec3 aState;
+in uint aKey;
+out vec3 vPosition;
+out vec3 vState;
+
+uniform vec3 uVertices[4];
+uniform uint uCount;
+uniform uint uCounter;
+uniform uint uSteps;
+
+void main()
+{
+    // precise keeps 0.5 * (p + v) two roundings, as on the CPU, rather than
+    // letting the compiler fuse them
+    PRECISE vec3 p = aState;
+    for (uint t = 0u; t < uSteps; ++t) {
+        p = 0.5 * (p + uVertices[uniform_index(counter_rng(aKey, uCounter + t), uCount)]);
+    }
+    vPosition = p;
+    vState = p;
+}
@@ -0,0 +1,19 @@
+// counter_rng and uniform_index of src/icg/random.h, bit for bit.
+
+uint counter_rng(uint key, uint counter)
+{
+    // Weyl sequence scrambled by the murmur3 finalizer
+    uint x = counter * 0x9e3779b9u + key;
+    x = (x ^ (x >> 16)) * 0x85ebca6bu;
+    x = (x ^ (x >> 13)) * 0xc2b2ae35u;
+    x ^= (x >> 16) ^ key;
+    // keyed again and scrambled by the lowbias32 finalizer
+    x = (x ^ (x >> 16)) * 0x7feb352du;
+    x = (x ^ (x >> 15)) * 0x846ca68bu;
+    return x ^ (x >> 16);
+}
+
+uint uniform_index(uint random, uint n)
+{
+    return ((random >> 16) * n) >> 16;
+}
@@ -0,0 +1,15 @@
+#version 330
+
+#include "tone_map.glsl"
+
+in vec2 vTexCoord;
+out vec4 fColor;
+
+uniform usampler2D uDensity;
+uniform uint uMaxCount;
+
+void main()
+{
+    uint count = texelFetch(uDensity, ivec2(vTexCoord * vec2(textureSize(uDensity, 0))), 0).r;
+    fColor = mix(vec4(1.0), vec4(1.0, 0.0, 0.0, 1.0), log_density(count, uMaxCount));
+}
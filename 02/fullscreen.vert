@@ -0,0 +1,12 @@
+#version 330
+
+// Triangle covering the whole viewport, made from gl_VertexID alone so that
+// it needs no vertex buffer.
+out vec2 vTexCoord;
+
+void main()
+{
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    vTexCoord = p;
+    gl_Position = vec4(2.0 * p - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,71 @@
+#include "../main.h"
+#include "shaders.h"
+#include <icg/density.h>
+#include <icg/gl/density_texture.h>
+#include <icg/gl/shader_program.h>
+#include <icg/memory.h>
+#include <icg/shapes.h>
+#include <tinygl/tinygl.h>
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <random>
+
+constexpr std::size_t num_positions = 100'000'000;
+
+class window : public tinygl::window
+{
+public:
+    using tinygl::window::window;
+    void init() override;
+    void process_input() override;
+    void draw() override;
+private:
+    icg::gl::shader_program program;
+    icg::gl::density_texture density;
+    tinygl::vertex_array_object vao;
+};
+
+void window::init()
+{
+    // Configure OpenGL
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+
+    // Bin the points into one histogram per thread at the window resolution
+    // as they are generated, rather than keeping and drawing every one of them
+    // Each new point is located midway between last point and a randomly chosen vertex
+    auto const [width, height] = get_window_size();
+    auto const grid = icg::density_grid{
+        {-1.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 0.0f},
+        static_cast<std::size_t>(width), static_cast<std::size_t>(height)};
+    auto const start = std::chrono::steady_clock::now();
+    auto const binned = icg::chaos_game_density(icg::gasket_triangle, num_positions, std::random_device{}(), grid);
+    auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("Binned {} points into {}x{} bins in {:.3f} s ({:.0f} points/s), peak resident memory: {} KiB",
+        binned.total, grid.width, grid.height, seconds, num_positions / seconds, icg::peak_resident_bytes() / 1024);
+    density.upload(binned);
+
+    // Load shaders of the fullscreen pass, which tone-maps the density
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::fullscreen_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::density_frag);
+    program.link();
+    program.use();
+    program.set_uniform_value(program.uniform_location("uDensity"), 0);
+    program.set_uniform_value(program.uniform_location("uMaxCount"), static_cast<unsigned>(density.max_count()));
+}
+
+void window::process_input()
+{
+    if (get_key(tinygl::keyboard::key::escape) == tinygl::keyboard::key_state::press) {
+        set_should_close(true);
+    }
+}
+
+void window::draw()
+{
+    glClear(GL_COLOR_BUFFER_BIT);
+    density.bind(0);
+    vao.bind();
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+MAIN
@@ -1,38 +1,19 @@
 #include "../main.h"
+#include "shaders.h"
+#include <icg/geometry_cache.h>
+#include <icg/gl/shader_program.h>
+#include <icg/shapes.h>
+#include <icg/subdivision.h>
 #include <tinygl/tinygl.h>
+#include <spdlog/spdlog.h>
 #include <array>
+#include <chrono>
+#include <span>
 #include <vector>
 
 constexpr int num_times_to_subdivide = 5;
 
-auto positions = std::vector<tinyla::vec2f>{};
-
-void triangle(const tinyla::vec2f& a, const tinyla::vec2f& b, const tinyla::vec2f& c)
-{
-    positions.push_back(a);
-    positions.push_back(b);
-    positions.push_back(c);
-}
-
-void divide_triangle(const tinyla::vec2f& a, const tinyla::vec2f& b, const tinyla::vec2f& c, int count)
-{
-    // check for end of recursion
-    if (count == 0) {
-        triangle(a, b, c);
-    } else {
-        // bisect the sides
-        auto const ab = 0.5f * (a + b);
-        auto const ac = 0.5f * (a + c);
-        auto const bc = 0.5f * (b + c);
-        --count;
-        // three new triangles
-        divide_triangle(a, ab, ac, count);
-        divide_triangle(c, ac, bc, count);
-        divide_triangle(b, bc, ab, count);
-    }
-}
-
-class window final : public tinygl::window
+class window : public tinygl::window
 {
 public:
     using tinygl::window::window;
@@ -40,36 +21,53 @@ public:
     void process_input() override;
     void draw() override;
 private:
-    tinygl::shader_program program;
+    icg::gl::shader_program program;
     tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
     tinygl::vertex_array_object vao;
+    std::size_t num_positions{0};
 };
 
 void window::init()
 {
-    // First, initialize the corners of our gasket with three positions.
-    auto const vertices = std::array {
-        tinyla::vec2f{-1.0f, -1.0f},
-        tinyla::vec2f{ 0.0f,  1.0f},
-        tinyla::vec2f{ 1.0f, -1.0f}
-    };
-
-    divide_triangle(vertices[0], vertices[1], vertices[2], num_times_to_subdivide);
+    // The corners of our gasket are the three positions of icg::gasket_triangle.
+    auto const& vertices = icg::gasket_triangle;
 
     // Configure OpenGL
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     glEnable(GL_PROGRAM_POINT_SIZE);
 
     // Load shaders and initialize attribute buffers
-    program.add_shader_from_source_file(tinygl::shader::type::vertex, "gasket2.vert");
-    program.add_shader_from_source_file(tinygl::shader::type::fragment, "gasket2.frag");
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::gasket2_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::gasket2_frag);
     program.link();
     program.use();
 
     // Load the data into the GPU
     vao.bind();
     v_buffer.bind();
-    v_buffer.create(positions.begin(), positions.end());
+
+    // The triangles are subdivided on the first run only; later runs map them
+    // from the geometry cache straight into the buffer
+    auto const key = icg::geometry_key{"divide_triangle", icg::divide_triangle_version}.add(vertices).add(num_times_to_subdivide);
+    auto& cache = icg::default_geometry_cache();
+    auto const start = std::chrono::steady_clock::now();
+    // an entry with other sections than this stores is regenerated
+    auto const layout = icg::layout_of<icg::vec2>("ff");
+    auto const entry = cache.load(key);
+    auto const mapped = entry && entry->size() == 1 && entry->layout(0) == layout;
+    if (mapped) {
+        auto const positions = entry->elements<icg::vec2>(0);
+        v_buffer.create(positions.begin(), positions.end());
+        num_positions = positions.size();
+    } else {
+        auto const positions = icg::divide_triangle(vertices[0], vertices[1], vertices[2], num_times_to_subdivide);
+        v_buffer.create(positions.begin(), positions.end());
+        num_positions = positions.size();
+        auto const sections = std::array{icg::geometry_section{layout, positions.size(), std::as_bytes(std::span{positions})}};
+        cache.store(key, sections);
+    }
+    auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("{} {} positions in {:.3f} s", mapped ? "Mapped" : "Generated", num_positions, seconds);
 
     // Associate shader variables with our data buffer
     auto const position_loc = program.attribute_location("aPosition");
@@ -87,7 +85,7 @@ void window::process_input()
 void window::draw()
 {
     glClear(GL_COLOR_BUFFER_BIT);
-    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(positions.size()));
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(num_positions));
 }
 
 MAIN
@@ -0,0 +1,111 @@
+#include "../main.h"
+#include "shaders.h"
+#include <icg/chaos_game_chains.h>
+#include <icg/gl/shader_program.h>
+#include <icg/gl/transform_feedback_chaos_game.h>
+#include <tinygl/tinygl.h>
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <random>
+
+// Chains advanced in parallel on the GPU, and points generated per chain.
+// Every step is a single draw of one vertex per chain, so there have to be
+// enough chains to keep the whole GPU busy.
+constexpr std::size_t num_chains = 131'072;
+constexpr std::size_t num_steps = 16;
+constexpr std::size_t num_positions = num_chains * num_steps;
+
+class window : public tinygl::window
+{
+public:
+    using tinygl::window::window;
+    void init() override;
+    void process_input() override;
+    void draw() override;
+private:
+    void verify(std::uint32_t seed, double gpu_seconds);
+
+    icg::gl::shader_program feedback;
+    icg::gl::shader_program program;
+    tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
+    tinygl::vertex_array_object vao;
+    std::optional<icg::gl::transform_feedback_chaos_game> generator;
+};
+
+void window::init()
+{
+    // Configure OpenGL
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glEnable(GL_DEPTH_TEST);
+
+    // Generate the points on the GPU, straight into the vertex buffer
+    // Each new point is located midway between last point and a randomly chosen vertex
+    feedback.add_shader_from_source(tinygl::shader::type::vertex, shaders::chaos_game_vert);
+    feedback.set_transform_feedback_varyings({"vPosition", "vState"}, true);
+    feedback.link();
+    auto const seed = std::random_device{}();
+    generator.emplace(feedback, icg::gasket_tetrahedron, num_chains, seed);
+
+    auto const start = std::chrono::steady_clock::now();
+    generator->generate(v_buffer, num_steps);
+    glFinish();
+    verify(seed, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    // Load shaders and initialize attribute buffers
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::gasket3_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::gasket3_frag);
+    program.link();
+    program.use();
+
+    // Associate shader variables with our data buffer
+    vao.bind();
+    v_buffer.bind();
+    auto const position_loc = program.attribute_location("aPosition");
+    vao.set_attribute_array(position_loc, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    vao.enable_attribute_array(position_loc);
+}
+
+// Checks the points against the CPU reference, which should match them bit for
+// bit, and compares the throughput of the two.
+void window::verify(std::uint32_t seed, double gpu_seconds)
+{
+    auto const start = std::chrono::steady_clock::now();
+    auto const reference = icg::chaos_game_chains(icg::gasket_tetrahedron, num_chains, num_steps, seed);
+    auto const cpu_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("{} points on the GPU at {:.0f} points/s, on the CPU at {:.0f} points/s",
+        num_positions, num_positions / gpu_seconds, num_positions / cpu_seconds);
+
+    auto const points = icg::gl::transform_feedback_chaos_game::read(v_buffer, num_positions);
+    auto mismatches = std::size_t{0};
+    for (std::size_t i = 0; i < num_positions; ++i) {
+        if (std::memcmp(&points[i], &reference[i], sizeof(icg::vec3)) != 0) {
+            if (mismatches++ == 0) {
+                spdlog::error("Point {} is ({}, {}, {}) instead of ({}, {}, {})", i,
+                    points[i].x, points[i].y, points[i].z, reference[i].x, reference[i].y, reference[i].z);
+            }
+        }
+    }
+    if (mismatches == 0) {
+        spdlog::info("GPU points match the CPU reference");
+    } else {
+        spdlog::error("{} of {} GPU points differ from the CPU reference", mismatches, num_positions);
+    }
+}
+
+void window::process_input()
+{
+    if (get_key(tinygl::keyboard::key::escape) == tinygl::keyboard::key_state::press) {
+        set_should_close(true);
+    }
+}
+
+void window::draw()
+{
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(num_positions));
+}
+
+MAIN
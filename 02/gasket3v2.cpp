@@ -1,12 +1,20 @@
 #include "../main.h"
+#include "shaders.h"
+#include <icg/chaos_game.h>
+#include <icg/gl/mapped_range.h>
+#include <icg/gl/shader_program.h>
+#include <icg/gl/vertex_layout.h>
+#include <icg/memory.h>
 #include <tinygl/tinygl.h>
-#include <array>
+#include <spdlog/spdlog.h>
+#include <algorithm>
 #include <random>
+#include <span>
 #include <vector>
 
 constexpr int num_positions = 5000;
 
-class window final : public tinygl::window
+class window : public tinygl::window
 {
 public:
     using tinygl::window::window;
@@ -14,48 +22,16 @@ public:
     void process_input() override;
     void draw() override;
 private:
-    tinygl::shader_program program;
-    tinygl::buffer vbo_positions{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
-    tinygl::buffer vbo_colors{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
+    icg::gl::shader_program program;
+    tinygl::buffer vbo{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
     tinygl::vertex_array_object vao;
 };
 
 void window::init()
 {
-    auto positions = std::vector<tinyla::vec3f>{};
-    positions.reserve(num_positions);
-
-    auto colors = std::vector<tinyla::vec4f>{};
-    colors.reserve(num_positions);
-
-    // First, initialize the vertices of our 3D gasket.
-    auto vertices = std::array {
-        tinyla::vec3f{-0.5f, -0.5f, -0.5f},
-        tinyla::vec3f{ 0.5f, -0.5f, -0.5f},
-        tinyla::vec3f{ 0.0f,  0.5f,  0.0f},
-        tinyla::vec3f{ 0.0f, -0.5f,  0.5f}
-    };
-
-    positions.emplace_back(0.0f, 0.0f, 0.0f);
-    colors.emplace_back(0.5f, 0.5f, 0.5f, 1.0f);
-
-    auto device = std::random_device{};
-    auto engine= std::mt19937{device()};
-    auto distribution = std::uniform_int_distribution<int>{0, 3};
-
-    // Compute new positions
+    // Compute new positions chunk by chunk
     // Each new point is located midway between last point and a randomly chosen vertex
-    for (int i = 0; i < num_positions; ++i) {
-        auto const j = distribution(engine);
-        auto const new_position = 0.5f * (positions[i] + vertices[j]);
-        positions.push_back(new_position);
-        colors.emplace_back(
-            (1.0f + new_position[0]) / 2.0f,
-            (1.0f + new_position[1]) / 2.0f,
-            (1.0f + new_position[2]) / 2.0f,
-            1.0f
-        );
-    }
+    auto stream = icg::chaos_game_stream(icg::gasket_tetrahedron, num_positions, std::random_device{}());
 
     // Configure OpenGL
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
@@ -63,27 +39,39 @@ void window::init()
     glEnable(GL_DEPTH_TEST);
 
     // Load shaders and initialize attribute buffers
-    program.add_shader_from_source_file(tinygl::shader::type::vertex, "gasket3v2.vert");
-    program.add_shader_from_source_file(tinygl::shader::type::fragment, "gasket3.frag");
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::gasket3v2_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::gasket3_frag);
     program.link();
     program.use();
 
     // Load the data into the GPU
     vao.bind();
 
-    vbo_positions.bind();
-    vbo_positions.create(positions.begin(), positions.end());
-
-    auto const vertex_position_loc = program.attribute_location("aPosition");
-    vao.set_attribute_array(vertex_position_loc, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(vertex_position_loc);
-
-    vbo_colors.bind();
-    vbo_colors.create(colors.begin(), colors.end());
+    // Positions and colors interleaved in a single buffer, 16 bytes per point
+    vbo.bind();
+    vbo.create(sizeof(icg::gl::colored_vertex3) * num_positions);
+
+    // Only one chunk of positions is ever kept outside the vertex buffer
+    auto chunk = std::vector<icg::vec3>(std::min<std::size_t>(num_positions, icg::chaos_game_chunk_size));
+    for (auto count = stream.next_chunk_size(); count > 0; count = stream.next_chunk_size()) {
+        auto const first = stream.position();
+        auto const positions = std::span{chunk}.first(count);
+        stream.generate(positions);
+
+        auto const vertices = icg::gl::mapped_range<icg::gl::colored_vertex3>{GL_ARRAY_BUFFER, first, count};
+        std::ranges::transform(positions, vertices.span().begin(), [](const icg::vec3& position) {
+            return icg::gl::colored_vertex3{
+                position,
+                icg::pack_rgba8(
+                    (1.0f + position.x) / 2.0f,
+                    (1.0f + position.y) / 2.0f,
+                    (1.0f + position.z) / 2.0f)
+            };
+        });
+    }
+    spdlog::info("Peak resident memory: {} KiB", icg::peak_resident_bytes() / 1024);
 
-    auto const color_loc = program.attribute_location("aColor");
-    vao.set_attribute_array(color_loc, 4, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(color_loc);
+    icg::gl::set_vertex_layout<icg::gl::colored_vertex3>(vao, program);
 }
 
 void window::process_input()
@@ -1,64 +1,21 @@
 #include "../main.h"
+#include "shaders.h"
+#include <icg/geometry_cache.h>
+#include <icg/gl/shader_program.h>
+#include <icg/gl/vertex_layout.h>
+#include <icg/shapes.h>
+#include <icg/subdivision.h>
 #include <tinygl/tinygl.h>
+#include <spdlog/spdlog.h>
 #include <array>
+#include <chrono>
+#include <span>
+#include <variant>
 #include <vector>
 
 constexpr int num_times_to_subdivide = 3;
 
-auto const base_colors = std::array {
-    tinyla::vec3f{1.0f, 0.0f, 0.0f},
-    tinyla::vec3f{0.0f, 1.0f, 0.0f},
-    tinyla::vec3f{0.0f, 0.0f, 1.0f},
-    tinyla::vec3f{0.0f, 0.0f, 0.0f}
-};
-
-auto positions = std::vector<tinyla::vec3f>{};
-auto colors = std::vector<tinyla::vec3f>{};
-
-void triangle(const tinyla::vec3f& a, const tinyla::vec3f& b, const tinyla::vec3f& c, int color)
-{
-    // add colors and vertices for one triangle
-    colors.push_back(base_colors.at(color));
-    positions.push_back(a);
-    colors.push_back(base_colors.at(color));
-    positions.push_back(b);
-    colors.push_back(base_colors.at(color));
-    positions.push_back(c);
-}
-
-void tetra(const tinyla::vec3f& a, const tinyla::vec3f& b, const tinyla::vec3f& c, const tinyla::vec3f& d)
-{
-    // tetrahedron with each side using a different color
-    triangle(a, c, b, 0);
-    triangle(a, c, d, 1);
-    triangle(a, b, d, 2);
-    triangle(b, c, d, 3);
-}
-
-void divide_tetra(const tinyla::vec3f& a, const tinyla::vec3f& b, const tinyla::vec3f& c, const tinyla::vec3f& d, int count)
-{
-    // check for end of recursion
-    if (count == 0) {
-        tetra(a, b, c, d);
-    } else {
-        // find midpoints of sides, divide four smaller tetrahedra
-        auto const ab = 0.5f * (a + b);
-        auto const ac = 0.5f * (a + c);
-        auto const ad = 0.5f * (a + d);
-        auto const bc = 0.5f * (b + c);
-        auto const bd = 0.5f * (b + d);
-        auto const cd = 0.5f * (c + d);
-
-        --count;
-
-        divide_tetra( a, ab, ac, ad, count);
-        divide_tetra(ab,  b, bc, bd, count);
-        divide_tetra(ac, bc,  c, cd, count);
-        divide_tetra(ad, bd, cd,  d, count);
-    }
-}
-
-class window final : public tinygl::window
+class window : public tinygl::window
 {
 public:
     using tinygl::window::window;
@@ -66,23 +23,18 @@ public:
     void process_input() override;
     void draw() override;
 private:
-    tinygl::shader_program program;
+    icg::gl::shader_program program;
     tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
-    tinygl::buffer c_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
+    tinygl::buffer i_buffer{tinygl::buffer::type::index_buffer, tinygl::buffer::usage_pattern::static_draw};
     tinygl::vertex_array_object vao;
+    std::size_t num_indices{0};
+    GLenum index_type{GL_UNSIGNED_SHORT};
 };
 
 void window::init()
 {
-    // First, initialize the corners of our gasket with three positions.
-    auto vertices = std::array {
-        tinyla::vec3f{ 0.0000f,  0.0000f, -1.0000f},
-        tinyla::vec3f{ 0.0000f,  0.9428f,  0.3333f},
-        tinyla::vec3f{-0.8165f, -0.4714f,  0.3333f},
-        tinyla::vec3f{ 0.8165f, -0.4714f,  0.3333f}
-    };
-
-    divide_tetra(vertices[0], vertices[1], vertices[2], vertices[3], num_times_to_subdivide);
+    // The corners of our gasket are the vertices of icg::gasket_regular_tetrahedron.
+    auto const& vertices = icg::gasket_regular_tetrahedron;
 
     // Configure OpenGL
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
@@ -90,27 +42,70 @@ void window::init()
     glEnable(GL_DEPTH_TEST);
 
     // Load shaders and initialize attribute buffers
-    program.add_shader_from_source_file(tinygl::shader::type::vertex, "gasket4.vert");
-    program.add_shader_from_source_file(tinygl::shader::type::fragment, "gasket4.frag");
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::gasket4_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::gasket4_frag);
     program.link();
     program.use();
 
     // Load the data into the GPU
     vao.bind();
 
-    v_buffer.bind();
-    v_buffer.create(positions.begin(), positions.end());
+    // The mesh is generated on the first run only; later runs map it from the
+    // geometry cache and upload it without building or parsing anything
+    auto const upload = [this](std::span<const icg::gl::colored_vertex3> interleaved, auto indices) {
+        v_buffer.bind();
+        v_buffer.create(interleaved.begin(), interleaved.end());
+        icg::gl::set_vertex_layout<icg::gl::colored_vertex3>(vao, program);
+
+        i_buffer.bind();
+        i_buffer.create(indices.begin(), indices.end());
+        num_indices = indices.size();
+        index_type = sizeof(indices[0]) == sizeof(std::uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    };
 
-    auto const position_loc = program.attribute_location("aPosition");
-    vao.set_attribute_array(position_loc, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(position_loc);
+    auto const key = icg::geometry_key{"divide_tetra_indexed", icg::divide_tetra_indexed_version}.add(vertices).add(num_times_to_subdivide);
+    auto& cache = icg::default_geometry_cache();
+    auto const start = std::chrono::steady_clock::now();
+    // an entry with other sections than this stores is regenerated
+    auto const vertex_layout = icg::layout_of<icg::gl::colored_vertex3>("fffBBBB");
+    auto const short_layout = icg::layout_of<std::uint16_t>("H");
+    auto const int_layout = icg::layout_of<std::uint32_t>("I");
+    auto const entry = cache.load(key);
+    if (entry && entry->size() == 2 && entry->layout(0) == vertex_layout
+        && (entry->layout(1) == short_layout || entry->layout(1) == int_layout)) {
+        auto const interleaved = entry->elements<icg::gl::colored_vertex3>(0);
+        if (entry->layout(1) == short_layout) {
+            upload(interleaved, entry->elements<std::uint16_t>(1));
+        } else {
+            upload(interleaved, entry->elements<std::uint32_t>(1));
+        }
+        auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        spdlog::info("Mapped the mesh from {} in {:.3f} s", cache.path(key).string(), seconds);
+        return;
+    }
 
-    c_buffer.bind();
-    c_buffer.create(colors.begin(), colors.end());
+    auto const mesh = icg::divide_tetra_indexed(vertices[0], vertices[1], vertices[2], vertices[3], num_times_to_subdivide);
 
-    auto const color_loc = program.attribute_location("aColor");
-    vao.set_attribute_array(color_loc, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(color_loc);
+    auto const reduction = icg::reduction<icg::gl::colored_vertex3>(mesh);
+    spdlog::info("Indexed mesh: {} vertices instead of {}, {} bytes instead of {}{}",
+        reduction.indexed_vertices, reduction.flat_vertices, reduction.indexed_bytes, reduction.flat_bytes,
+        reduction.saves() ? "" : ", indexing does not help");
+
+    // Positions and colors interleaved in a single buffer
+    auto interleaved = std::vector<icg::gl::colored_vertex3>(mesh.num_vertices());
+    for (std::size_t i = 0; i < interleaved.size(); ++i) {
+        interleaved[i] = {mesh.positions[i], icg::pack_rgba8(mesh.colors[i])};
+    }
+    std::visit([&](auto const& indices) {
+        using index = typename std::decay_t<decltype(indices)>::value_type;
+        upload(interleaved, std::span<const index>{indices});
+        auto const sections = std::array{
+            icg::geometry_section{vertex_layout, interleaved.size(), std::as_bytes(std::span{interleaved})},
+            icg::geometry_section{sizeof(index) == sizeof(std::uint16_t) ? short_layout : int_layout, indices.size(), std::as_bytes(std::span{indices})}};
+        cache.store(key, sections);
+    }, mesh.indices);
+    auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("Generated the mesh in {:.3f} s, cached in {}", seconds, cache.path(key).string());
 }
 
 void window::process_input()
@@ -123,7 +118,7 @@ void window::process_input()
 void window::draw()
 {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(positions.size()));
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(num_indices), index_type, 0);
 }
 
 MAIN
@@ -0,0 +1,100 @@
+#include "../main.h"
+#include "shaders.h"
+#include <icg/gl/input_window.h>
+#include <icg/gl/shader_program.h>
+#include <icg/ifs.h>
+#include <icg/shapes.h>
+#include <tinygl/tinygl.h>
+#include <spdlog/spdlog.h>
+#include <array>
+#include <chrono>
+#include <random>
+
+constexpr std::size_t num_positions = 1'000'000;
+
+// Fractals selected with the keys 1 to 4.
+const auto fractals = std::array {
+    icg::gasket_ifs(icg::gasket_triangle),
+    icg::heighway_dragon(),
+    icg::barnsley_fern(),
+    icg::sierpinski_carpet()
+};
+
+class window : public icg::gl::input_window
+{
+public:
+    using icg::gl::input_window::input_window;
+    void init() override;
+    void process_input() override;
+    void draw() override;
+private:
+    void generate(std::size_t fractal);
+
+    icg::gl::shader_program program;
+    tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
+    tinygl::vertex_array_object vao;
+    std::uint32_t seed{std::random_device{}()};
+};
+
+void window::init()
+{
+    // Configure OpenGL
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    // Load shaders and initialize attribute buffers
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::gasket1_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::gasket1_frag);
+    program.link();
+    program.use();
+
+    vao.bind();
+    generate(0);
+
+    // Associate shader variables with our data buffer
+    auto const position_loc = program.attribute_location("aPosition");
+    vao.set_attribute_array(position_loc, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    vao.enable_attribute_array(position_loc);
+
+    set_key_callback([this](tinygl::keyboard::key key, int /*scancode*/, tinygl::input::action action, tinygl::input::modifier /*mods*/) {
+        auto constexpr keys = std::array {
+            tinygl::keyboard::key::d1,
+            tinygl::keyboard::key::d2,
+            tinygl::keyboard::key::d3,
+            tinygl::keyboard::key::d4
+        };
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (key == keys[i] && action == tinygl::input::action::press) {
+                generate(i);
+            }
+        }
+    });
+}
+
+// Each new point is the image of the last point under a randomly chosen map
+void window::generate(std::size_t fractal)
+{
+    auto const start = std::chrono::steady_clock::now();
+    auto const positions = icg::parallel_ifs(fractals[fractal], num_positions, seed);
+    auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("Generated {} points of fractal {} with {} maps in {:.1f} ms",
+        positions.size(), fractal + 1, fractals[fractal].maps.size(), 1e3 * seconds);
+
+    v_buffer.bind();
+    v_buffer.create(positions.begin(), positions.end());
+}
+
+void window::process_input()
+{
+    if (get_key(tinygl::keyboard::key::escape) == tinygl::keyboard::key_state::press) {
+        set_should_close(true);
+    }
+}
+
+void window::draw()
+{
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(num_positions));
+}
+
+MAIN
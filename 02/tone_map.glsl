@@ -0,0 +1,6 @@
+// Log density: 0 for empty bins and 1 for the densest one, so that sparse
+// parts of the fractal stay visible next to the dense ones.
+float log_density(uint count, uint maxCount)
+{
+    return log(1.0 + float(count)) / log(1.0 + float(max(maxCount, 1u)));
+}
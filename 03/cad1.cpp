@@ -1,33 +1,42 @@
 #include "../main.h"
+#include "shaders.h"
+#include <icg/gl/input_window.h>
+#include <icg/gl/multi_draw.h>
+#include <icg/gl/shader_program.h>
+#include <icg/gl/staging_buffer.h>
+#include <icg/gl/vertex_layout.h>
 #include <tinygl/tinygl.h>
 #include <array>
+#include <vector>
 
-constexpr auto max_num_triangles = 200;
-constexpr auto max_num_positions  = 3 * max_num_triangles;
 constexpr std::array colors = {
-    tinyla::vec4f{0.0f, 0.0f, 0.0f, 1.0f},  // black
-    tinyla::vec4f{1.0f, 0.0f, 0.0f, 1.0f},  // red
-    tinyla::vec4f{1.0f, 1.0f, 0.0f, 1.0f},  // yellow
-    tinyla::vec4f{0.0f, 1.0f, 0.0f, 1.0f},  // green
-    tinyla::vec4f{0.0f, 0.0f, 1.0f, 1.0f},  // blue
-    tinyla::vec4f{1.0f, 0.0f, 1.0f, 1.0f},  // magenta
-    tinyla::vec4f{0.0f, 1.0f, 1.0f, 1.0f}   // cyan
+    icg::rgba8{  0,   0,   0, 255},  // black
+    icg::rgba8{255,   0,   0, 255},  // red
+    icg::rgba8{255, 255,   0, 255},  // yellow
+    icg::rgba8{  0, 255,   0, 255},  // green
+    icg::rgba8{  0,   0, 255, 255},  // blue
+    icg::rgba8{255,   0, 255, 255},  // magenta
+    icg::rgba8{  0, 255, 255, 255}   // cyan
 };
 
-class window final : public tinygl::window
+// The UI control recorded with an input_window, set to the index of the color.
+constexpr int color_control = 0;
+
+class window : public icg::gl::input_window
 {
 public:
-    using tinygl::window::window;
+    using icg::gl::input_window::input_window;
     void init() override;
     void process_input() override;
     void draw() override;
     void draw_ui() override;
 private:
-    tinygl::shader_program program;
+    icg::gl::shader_program program;
     tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
-    tinygl::buffer c_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
+    icg::gl::staging_buffer<icg::gl::colored_vertex2> vertices{v_buffer};
     tinygl::vertex_array_object vao;
-    int index{0};
+    std::vector<std::size_t> rectangles;
+    icg::draw_batch fans;
     int c_index{0};
     bool first{true};
     std::array<tinyla::vec2f, 4> t{
@@ -44,25 +53,18 @@ void window::init()
     glEnable(GL_PROGRAM_POINT_SIZE);
 
     // Load shaders and initialize attribute buffers.
-    program.add_shader_from_source_file(tinygl::shader::type::vertex, "cad.vert");
-    program.add_shader_from_source_file(tinygl::shader::type::fragment, "cad.frag");
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::cad_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::cad_frag);
     program.link();
     program.use();
 
     vao.bind();
-    v_buffer.bind();
-    v_buffer.create(sizeof(tinyla::vec2f) * max_num_positions);
-
-    auto positionLoc = program.attribute_location("aPosition");
-    vao.set_attribute_array(positionLoc, 2, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(positionLoc);
-
-    c_buffer.bind();
-    c_buffer.create(sizeof(tinyla::vec4f) * max_num_positions);
+    vertices.create();
+    icg::gl::set_vertex_layout<icg::gl::colored_vertex2>(vao, program);
 
-    auto colorLoc = program.attribute_location("aColor");
-    vao.set_attribute_array(colorLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(colorLoc);
+    set_ui_callback([this](std::int32_t /*control*/, std::int32_t value) {
+        c_index = value;
+    });
 
     set_mouse_button_callback([this](
         tinygl::mouse::button button,
@@ -80,15 +82,24 @@ void window::init()
                 t[1] = tinyla::vec2f{t[0][0], t[2][1]};
                 t[3] = tinyla::vec2f{t[2][0], t[0][1]};
 
-                v_buffer.bind();
-                v_buffer.update(sizeof(tinyla::vec2f) * index, t.begin(), t.end());
-                index += 4;
-
-                c_buffer.bind();
                 const auto& tt = colors[c_index];
+                std::array<icg::gl::colored_vertex2, 4> quad{};
                 for (int i = 0; i < 4; ++i) {
-                    c_buffer.update(sizeof(tinyla::vec4f) * (index - 4 + i), sizeof(tinyla::vec4f), tt.data());
+                    quad[i] = {icg::vec2{t[i][0], t[i][1]}, tt};
                 }
+
+                auto const stored = vertices.store(quad);
+                // a new fan unless the rectangle took the place of a deleted one
+                if (stored == fans.size() * quad.size()) {
+                    fans.add(stored, quad.size());
+                }
+                rectangles.push_back(stored);
+            }
+        } else if (button == tinygl::mouse::button::right && action == tinygl::input::action::press) {
+            // delete the last rectangle, its vertices go to the next one drawn
+            if (!rectangles.empty()) {
+                vertices.release(rectangles.back(), 4);
+                rectangles.pop_back();
             }
         }
     });
@@ -103,10 +114,9 @@ void window::process_input()
 
 void window::draw()
 {
+    vertices.flush();
     glClear(GL_COLOR_BUFFER_BIT);
-    for(int i = 0; i < index; i += 4) {
-        glDrawArrays(GL_TRIANGLE_FAN, i, 4);
-    }
+    icg::gl::multi_draw(GL_TRIANGLE_FAN, fans);
 }
 
 void window::draw_ui()
@@ -122,7 +132,17 @@ void window::draw_ui()
         "magenta",
         "cyan"
     };
-    ImGui::ListBox("Color", &c_index, items, IM_ARRAYSIZE(items), 7);
+    // the pick goes through ui_action, so that a replay sees it too
+    auto picked = c_index;
+    if (ImGui::ListBox("Color", &picked, items, IM_ARRAYSIZE(items), 7)) {
+        ui_action(color_control, picked);
+    }
+
+    auto const& stats = vertices.total_stats();
+    ImGui::Text("Buffer edits: %zu, updates: %zu", stats.edits, stats.updates);
+    auto const& growth = vertices.storage().stats();
+    ImGui::Text("Buffer capacity: %zu, reallocations: %zu", vertices.capacity(), growth.reallocations);
+    ImGui::Text("Draw calls: 1 instead of %zu", fans.size());
 
     ImGui::End();
 }
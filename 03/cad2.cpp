@@ -1,36 +1,44 @@
 #include "../main.h"
+#include "shaders.h"
+#include <icg/gl/input_window.h>
+#include <icg/gl/multi_draw.h>
+#include <icg/gl/shader_program.h>
+#include <icg/gl/staging_buffer.h>
+#include <icg/gl/vertex_layout.h>
 #include <tinygl/tinygl.h>
 #include <array>
 
-constexpr auto max_num_positions  = 200;
 constexpr std::array colors = {
-    tinyla::vec4f{0.0f, 0.0f, 0.0f, 1.0f},  // black
-    tinyla::vec4f{1.0f, 0.0f, 0.0f, 1.0f},  // red
-    tinyla::vec4f{1.0f, 1.0f, 0.0f, 1.0f},  // yellow
-    tinyla::vec4f{0.0f, 1.0f, 0.0f, 1.0f},  // green
-    tinyla::vec4f{0.0f, 0.0f, 1.0f, 1.0f},  // blue
-    tinyla::vec4f{1.0f, 0.0f, 1.0f, 1.0f},  // magenta
-    tinyla::vec4f{0.0f, 1.0f, 1.0f, 1.0f}   // cyan
+    icg::rgba8{  0,   0,   0, 255},  // black
+    icg::rgba8{255,   0,   0, 255},  // red
+    icg::rgba8{255, 255,   0, 255},  // yellow
+    icg::rgba8{  0, 255,   0, 255},  // green
+    icg::rgba8{  0,   0, 255, 255},  // blue
+    icg::rgba8{255,   0, 255, 255},  // magenta
+    icg::rgba8{  0, 255, 255, 255}   // cyan
 };
 
-class window final : public tinygl::window
+// UI controls recorded with an input_window: the color list, set to the index
+// of the color, and the End Polygon button.
+constexpr int color_control = 0;
+constexpr int end_polygon_control = 1;
+
+class window : public icg::gl::input_window
 {
 public:
-    using tinygl::window::window;
+    using icg::gl::input_window::input_window;
     void init() override;
     void process_input() override;
     void draw() override;
     void draw_ui() override;
 private:
-    tinygl::shader_program program;
+    icg::gl::shader_program program;
     tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
-    tinygl::buffer c_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
+    icg::gl::staging_buffer<icg::gl::colored_vertex2> vertices{v_buffer};
     tinygl::vertex_array_object vao;
-    int index{0};
     int c_index{0};
-    int num_polygons{0};
-    std::vector<int> num_positions{0};
-    std::vector<int> start{0};
+    icg::draw_batch polygons;
+    std::size_t polygon_start{0};
 };
 
 void window::init()
@@ -39,25 +47,23 @@ void window::init()
     glEnable(GL_PROGRAM_POINT_SIZE);
 
     // Load shaders and initialize attribute buffers.
-    program.add_shader_from_source_file(tinygl::shader::type::vertex, "cad.vert");
-    program.add_shader_from_source_file(tinygl::shader::type::fragment, "cad.frag");
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::cad_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::cad_frag);
     program.link();
     program.use();
 
     vao.bind();
-    v_buffer.bind();
-    v_buffer.create(sizeof(tinyla::vec2f) * max_num_positions);
-
-    auto positionLoc = program.attribute_location("aPosition");
-    vao.set_attribute_array(positionLoc, 2, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(positionLoc);
-
-    c_buffer.bind();
-    c_buffer.create(sizeof(tinyla::vec4f) * max_num_positions);
-
-    auto colorLoc = program.attribute_location("aColor");
-    vao.set_attribute_array(colorLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(colorLoc);
+    vertices.create();
+    icg::gl::set_vertex_layout<icg::gl::colored_vertex2>(vao, program);
+
+    set_ui_callback([this](std::int32_t control, std::int32_t value) {
+        if (control == color_control) {
+            c_index = value;
+        } else if (control == end_polygon_control) {
+            polygons.add(polygon_start, vertices.size() - polygon_start);
+            polygon_start = vertices.size();
+        }
+    });
 
     set_mouse_button_callback([this](
         tinygl::mouse::button button,
@@ -67,16 +73,8 @@ void window::init()
             const auto [x, y] = get_cursor_pos<float>();
             const auto [w, h] = get_window_size();
 
-            const auto t = tinyla::vec2f{2*x/w - 1, 2*(h-y)/h - 1};
-            v_buffer.bind();
-            v_buffer.update(sizeof(tinyla::vec2f) * index, sizeof(tinyla::vec2f), t.data());
-
-            const auto& tt = colors[c_index];
-            c_buffer.bind();
-            c_buffer.update(sizeof(tinyla::vec4f) * index, sizeof(tinyla::vec4f), tt.data());
-
-            num_positions[num_polygons]++;
-            index++;
+            const auto t = icg::gl::colored_vertex2{icg::vec2{2*x/w - 1, 2*(h-y)/h - 1}, colors[c_index]};
+            vertices.append(t);
         }
     });
 }
@@ -90,10 +88,9 @@ void window::process_input()
 
 void window::draw()
 {
+    vertices.flush();
     glClear(GL_COLOR_BUFFER_BIT);
-    for (int i = 0; i < num_polygons; ++i) {
-        glDrawArrays(GL_TRIANGLE_FAN, start[i], num_positions[i]);
-    }
+    icg::gl::multi_draw(GL_TRIANGLE_FAN, polygons);
 }
 
 void window::draw_ui()
@@ -109,12 +106,20 @@ void window::draw_ui()
         "magenta",
         "cyan"
     };
-    ImGui::ListBox("Color", &c_index, items, IM_ARRAYSIZE(items), 7);
+    // the pick goes through ui_action, so that a replay sees it too
+    auto picked = c_index;
+    if (ImGui::ListBox("Color", &picked, items, IM_ARRAYSIZE(items), 7)) {
+        ui_action(color_control, picked);
+    }
+
+    auto const& stats = vertices.total_stats();
+    ImGui::Text("Buffer edits: %zu, updates: %zu", stats.edits, stats.updates);
+    auto const& growth = vertices.storage().stats();
+    ImGui::Text("Buffer capacity: %zu, reallocations: %zu", vertices.capacity(), growth.reallocations);
+    ImGui::Text("Draw calls: 1 instead of %zu", polygons.size());
 
     if (ImGui::Button("End Polygon")) {
-        num_polygons++;
-        num_positions.push_back(0);
-        start.push_back(index);
+        ui_action(end_polygon_control, 0);
     }
 
     ImGui::End();
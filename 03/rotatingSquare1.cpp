@@ -1,8 +1,14 @@
 #include "../main.h"
+#include "shaders.h"
+#include <icg/frame_clock.h>
+#include <icg/gl/shader_program.h>
 #include <tinygl/tinygl.h>
 #include <array>
 
-class window final : public tinygl::window
+// radians per second, what 0.1 per frame was at 60 Hz
+constexpr float angular_velocity = 6.0f;
+
+class window : public tinygl::window
 {
 public:
     using tinygl::window::window;
@@ -10,10 +16,11 @@ public:
     void process_input() override;
     void draw() override;
 private:
-    tinygl::shader_program program;
+    icg::gl::shader_program program;
     tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
     tinygl::vertex_array_object vao;
 
+    icg::frame_clock clock;
     float theta = 0.0f;
     int theta_loc = -1;
 };
@@ -25,8 +32,8 @@ void window::init()
     glEnable(GL_PROGRAM_POINT_SIZE);
 
     // Load shaders and initialize attribute buffers.
-    program.add_shader_from_source_file(tinygl::shader::type::vertex, "rotatingSquare.vert");
-    program.add_shader_from_source_file(tinygl::shader::type::fragment, "rotatingSquare.frag");
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::rotatingSquare_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::rotatingSquare_frag);
     program.link();
     program.use();
 
@@ -61,7 +68,7 @@ void window::draw()
 {
     glClear(GL_COLOR_BUFFER_BIT);
 
-    theta += 0.1f;
+    theta += angular_velocity * clock.tick();
     program.set_uniform_value(theta_loc, theta);
 
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
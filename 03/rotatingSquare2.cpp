@@ -1,27 +1,41 @@
 #include "../main.h"
+#include "shaders.h"
+#include <icg/frame_clock.h>
+#include <icg/gl/input_window.h>
+#include <icg/gl/shader_program.h>
 #include <tinygl/tinygl.h>
 #include <array>
 
-class window final : public tinygl::window
+// radians per second, what 0.1 per frame was at 60 Hz
+constexpr float angular_velocity = 6.0f;
+
+class window : public icg::gl::input_window
 {
 public:
-    using tinygl::window::window;
+    using icg::gl::input_window::input_window;
     void init() override;
     void process_input() override;
     void draw() override;
     void draw_ui() override;
 private:
-    tinygl::shader_program program;
+    icg::gl::shader_program program;
     tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
     tinygl::vertex_array_object vao;
 
+    icg::frame_clock clock;
     float theta = 0.0f;
     int theta_loc = -1;
 
     bool direction = true;
     float speed_factor = 1.0f;
+
+    void toggle(int item);
 };
 
+// The UI control recorded with an input_window, set to the item of the toggles
+// that was picked.
+constexpr int toggle_control = 0;
+
 void window::init()
 {
     // Configure OpenGL.
@@ -29,8 +43,8 @@ void window::init()
     glEnable(GL_PROGRAM_POINT_SIZE);
 
     // Load shaders and initialize attribute buffers.
-    program.add_shader_from_source_file(tinygl::shader::type::vertex, "rotatingSquare.vert");
-    program.add_shader_from_source_file(tinygl::shader::type::fragment, "rotatingSquare.frag");
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::rotatingSquare_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::rotatingSquare_frag);
     program.link();
     program.use();
 
@@ -53,19 +67,38 @@ void window::init()
 
     theta_loc = program.uniform_location("uTheta");
 
+    set_ui_callback([this](std::int32_t /*control*/, std::int32_t value) {
+        toggle(value);
+    });
+
     set_key_callback([this](tinygl::keyboard::key key, int /*scancode*/, tinygl::input::action action, tinygl::input::modifier /*mods*/) {
         if (key == tinygl::keyboard::key::d1 && action == tinygl::input::action::press) {
-            direction = !direction;
+            toggle(0);
         }
         if (key == tinygl::keyboard::key::d2 && action == tinygl::input::action::press) {
-            speed_factor *= 1.5f;
+            toggle(1);
         }
         if (key == tinygl::keyboard::key::d3 && action == tinygl::input::action::press) {
-            speed_factor /= 1.5f;
+            toggle(2);
         }
     });
 }
 
+void window::toggle(int item)
+{
+    switch (item) {
+        case 0:
+            direction = !direction;
+            break;
+        case 1:
+            speed_factor *= 1.5f;
+            break;
+        case 2:
+            speed_factor /= 1.5f;
+            break;
+    }
+}
+
 void window::process_input()
 {
     if (get_key(tinygl::keyboard::key::escape) == tinygl::keyboard::key_state::press) {
@@ -77,7 +110,8 @@ void window::draw()
 {
     glClear(GL_COLOR_BUFFER_BIT);
 
-    theta += (direction ? 0.1f * speed_factor : -0.1f * speed_factor);
+    auto const velocity = angular_velocity * speed_factor;
+    theta += (direction ? velocity : -velocity) * clock.tick();
     program.set_uniform_value(theta_loc, theta);
 
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -88,7 +122,7 @@ void window::draw_ui()
     ImGui::Begin("Controls", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
 
     if (ImGui::Button("Change Rotation Direction")) {
-        direction = !direction;
+        ui_action(toggle_control, 0);
     }
 
     static int item = 0;
@@ -98,19 +132,12 @@ void window::draw_ui()
         "Spin Slower"
     };
     if (ImGui::ListBox("Toggles", &item, items, IM_ARRAYSIZE(items), 3)) {
-        switch (item) {
-            case 0:
-                direction = !direction;
-                break;
-            case 1:
-                speed_factor *= 1.5f;
-                break;
-            case 2:
-                speed_factor /= 1.5f;
-                break;
-        }
+        ui_action(toggle_control, item);
     }
 
+    auto const& uniforms = program.uniform_upload_stats();
+    ImGui::Text("Uniform uploads: %zu, skipped: %zu", uniforms.issued, uniforms.skipped);
+
     ImGui::End();
 }
 
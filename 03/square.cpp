@@ -1,32 +1,33 @@
 #include "../main.h"
+#include "shaders.h"
+#include <icg/gl/input_window.h>
+#include <icg/gl/shader_program.h>
+#include <icg/gl/staging_buffer.h>
+#include <icg/gl/vertex_layout.h>
 #include <tinygl/tinygl.h>
 
-constexpr auto max_num_triangles = 200;
-constexpr auto max_num_positions  = 3 * max_num_triangles;
-
 constexpr std::array colors = {
-    tinyla::vec4f{0.0f, 0.0f, 0.0f, 1.0f},  // black
-    tinyla::vec4f{1.0f, 0.0f, 0.0f, 1.0f},  // red
-    tinyla::vec4f{1.0f, 1.0f, 0.0f, 1.0f},  // yellow
-    tinyla::vec4f{0.0f, 1.0f, 0.0f, 1.0f},  // green
-    tinyla::vec4f{0.0f, 0.0f, 1.0f, 1.0f},  // blue
-    tinyla::vec4f{1.0f, 0.0f, 1.0f, 1.0f},  // magenta
-    tinyla::vec4f{0.0f, 1.0f, 1.0f, 1.0f}   // cyan
+    icg::rgba8{  0,   0,   0, 255},  // black
+    icg::rgba8{255,   0,   0, 255},  // red
+    icg::rgba8{255, 255,   0, 255},  // yellow
+    icg::rgba8{  0, 255,   0, 255},  // green
+    icg::rgba8{  0,   0, 255, 255},  // blue
+    icg::rgba8{255,   0, 255, 255},  // magenta
+    icg::rgba8{  0, 255, 255, 255}   // cyan
 };
 
-class window final : public tinygl::window
+class window : public icg::gl::input_window
 {
 public:
-    using tinygl::window::window;
+    using icg::gl::input_window::input_window;
     void init() override;
     void process_input() override;
     void draw() override;
 private:
-    tinygl::shader_program program;
+    icg::gl::shader_program program;
     tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
-    tinygl::buffer c_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
+    icg::gl::staging_buffer<icg::gl::colored_vertex2> vertices{v_buffer};
     tinygl::vertex_array_object vao;
-    int index = 0;
 };
 
 void window::init()
@@ -36,17 +37,13 @@ void window::init()
             tinygl::input::action action,
             tinygl::input::modifier /* modifier */) {
         if (button == tinygl::mouse::button::left && action == tinygl::input::action::press) {
-            v_buffer.bind();
             const auto [x, y] = get_cursor_pos<float>();
             const auto [w, h] = get_window_size();
-            auto p = tinyla::vec2f{static_cast<float>(2*x/w - 1), static_cast<float>(2*(h-y)/h - 1)};
-            v_buffer.update(sizeof(p) * index, sizeof(p), p.data());
-
-            c_buffer.bind();
-            auto c = colors.at(index%7);
-            c_buffer.update(sizeof(c) * index, sizeof(c), c.data());
-
-            index++;
+            auto v = icg::gl::colored_vertex2{
+                icg::vec2{static_cast<float>(2*x/w - 1), static_cast<float>(2*(h-y)/h - 1)},
+                colors.at(vertices.size()%7)
+            };
+            vertices.append(v);
         }
     });
     // Configure OpenGL
@@ -54,27 +51,16 @@ void window::init()
     glEnable(GL_PROGRAM_POINT_SIZE);
 
     // Load shaders and initialize attribute buffers
-    program.add_shader_from_source_file(tinygl::shader::type::vertex, "square.vert");
-    program.add_shader_from_source_file(tinygl::shader::type::fragment, "square.frag");
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::square_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::square_frag);
     program.link();
     program.use();
 
     // Load the data into the GPU
     vao.bind();
 
-    v_buffer.bind();
-    v_buffer.create(sizeof(tinyla::vec2f) * max_num_positions);
-
-    auto positionLoc = program.attribute_location("aPosition");
-    vao.set_attribute_array(positionLoc, 2, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(positionLoc);
-
-    c_buffer.bind();
-    c_buffer.create(sizeof(tinyla::vec4f) * max_num_positions);
-
-    auto colorLoc = program.attribute_location("aColor");
-    vao.set_attribute_array(colorLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(colorLoc);
+    vertices.create();
+    icg::gl::set_vertex_layout<icg::gl::colored_vertex2>(vao, program);
 }
 
 void window::process_input()
@@ -86,8 +72,9 @@ void window::process_input()
 
 void window::draw()
 {
+    vertices.flush();
     glClear(GL_COLOR_BUFFER_BIT);
-    glDrawArrays(GL_POINTS, 0, index);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(vertices.size()));
 }
 
 MAIN
@@ -1,38 +1,52 @@
 #include "../main.h"
+#include "shaders.h"
+#include <icg/frame_clock.h>
+#include <icg/gl/input_window.h>
+#include <icg/gl/shader_program.h>
+#include <icg/gl/vertex_layout.h>
+#include <icg/transform.h>
 #include <tinygl/tinygl.h>
 #include <array>
+#include <cmath>
 
 constexpr int num_positions  = 36;
 constexpr int x_axis = 0;
 constexpr int y_axis = 1;
 constexpr int z_axis = 2;
 
+// The UI control recorded with an input_window, set to the axis to rotate about.
+constexpr int rotate_control = 0;
+
+// degrees per second, what 2 per frame was at 60 Hz
+constexpr float angular_velocity = 120.0f;
+
+// w = 1 is supplied by OpenGL for the missing fourth component of aPosition
 constexpr std::array vertices = {
-    tinyla::vec4f{-0.5f, -0.5f,  0.5f, 1.0f},
-    tinyla::vec4f{-0.5f,  0.5f,  0.5f, 1.0f},
-    tinyla::vec4f{ 0.5f,  0.5f,  0.5f, 1.0f},
-    tinyla::vec4f{ 0.5f, -0.5f,  0.5f, 1.0f},
-    tinyla::vec4f{-0.5f, -0.5f, -0.5f, 1.0f},
-    tinyla::vec4f{-0.5f,  0.5f, -0.5f, 1.0f},
-    tinyla::vec4f{ 0.5f,  0.5f, -0.5f, 1.0f},
-    tinyla::vec4f{ 0.5f, -0.5f, -0.5f, 1.0f}
+    icg::vec3{-0.5f, -0.5f,  0.5f},
+    icg::vec3{-0.5f,  0.5f,  0.5f},
+    icg::vec3{ 0.5f,  0.5f,  0.5f},
+    icg::vec3{ 0.5f, -0.5f,  0.5f},
+    icg::vec3{-0.5f, -0.5f, -0.5f},
+    icg::vec3{-0.5f,  0.5f, -0.5f},
+    icg::vec3{ 0.5f,  0.5f, -0.5f},
+    icg::vec3{ 0.5f, -0.5f, -0.5f}
 };
 
 constexpr std::array vertex_colors = {
-    tinyla::vec4f{0.0f, 0.0f, 0.0f, 1.0f},  // black
-    tinyla::vec4f{1.0f, 0.0f, 0.0f, 1.0f},  // red
-    tinyla::vec4f{1.0f, 1.0f, 0.0f, 1.0f},  // yellow
-    tinyla::vec4f{0.0f, 1.0f, 0.0f, 1.0f},  // green
-    tinyla::vec4f{0.0f, 0.0f, 1.0f, 1.0f},  // blue
-    tinyla::vec4f{1.0f, 0.0f, 1.0f, 1.0f},  // magenta
-    tinyla::vec4f{0.0f, 1.0f, 1.0f, 1.0f},  // cyan
-    tinyla::vec4f{1.0f, 1.0f, 1.0f, 1.0f}   // white
+    icg::rgba8{  0,   0,   0, 255},  // black
+    icg::rgba8{255,   0,   0, 255},  // red
+    icg::rgba8{255, 255,   0, 255},  // yellow
+    icg::rgba8{  0, 255,   0, 255},  // green
+    icg::rgba8{  0,   0, 255, 255},  // blue
+    icg::rgba8{255,   0, 255, 255},  // magenta
+    icg::rgba8{  0, 255, 255, 255},  // cyan
+    icg::rgba8{255, 255, 255, 255}   // white
 };
 
-class window final : public tinygl::window
+class window : public icg::gl::input_window
 {
 public:
-    using tinygl::window::window;
+    using icg::gl::input_window::input_window;
     void init() override;
     void process_input() override;
     void draw() override;
@@ -41,17 +55,16 @@ private:
     void color_cube();
     void quad(int a, int b, int c, int d);
 
-    std::vector<tinyla::vec4f> positions{};
-    std::vector<tinyla::vec4f> colors{};
+    std::vector<icg::gl::colored_vertex3> points{};
 
-    tinygl::shader_program program;
+    icg::gl::shader_program program;
     tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
-    tinygl::buffer c_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
     tinygl::vertex_array_object vao;
 
+    icg::frame_clock clock;
     tinyla::vec3f theta{0.0f, 0.0f, 0.0f};
     int axis = 0;
-    int theta_loc{-1};
+    int model_loc{-1};
 };
 
 void window::init()
@@ -64,29 +77,23 @@ void window::init()
     glEnable(GL_DEPTH_TEST);
 
     // Load shaders and initialize attribute buffers.
-    program.add_shader_from_source_file(tinygl::shader::type::vertex, "cube.vert");
-    program.add_shader_from_source_file(tinygl::shader::type::fragment, "cube.frag");
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::cube_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::cube_frag);
     program.link();
     program.use();
 
     // Load the data into the GPU
     vao.bind();
 
-    c_buffer.bind();
-    c_buffer.create(colors.begin(), colors.end());
-
-    auto colorLoc = program.attribute_location("aColor");
-    vao.set_attribute_array(colorLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(colorLoc);
-
     v_buffer.bind();
-    v_buffer.create(positions.begin(), positions.end());
+    v_buffer.create(points.begin(), points.end());
+    icg::gl::set_vertex_layout<icg::gl::colored_vertex3>(vao, program);
 
-    auto positionLoc = program.attribute_location("aPosition");
-    vao.set_attribute_array(positionLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(positionLoc);
+    model_loc = program.uniform_location("uModel");
 
-    theta_loc = program.uniform_location("uTheta");
+    set_ui_callback([this](std::int32_t /*control*/, std::int32_t value) {
+        axis = value;
+    });
 
     set_key_callback([this](tinygl::keyboard::key key, int /*scancode*/, tinygl::input::action action, tinygl::input::modifier /*mods*/) {
         if (key == tinygl::keyboard::key::x && action == tinygl::input::action::press) {
@@ -112,8 +119,11 @@ void window::draw()
 {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    theta[axis] += 2.0f;
-    program.set_uniform_value(theta_loc, theta);
+    // kept in [0, 360), where icg::rotation's sine and cosine are accurate
+    theta[axis] += angular_velocity * clock.tick();
+    theta[axis] -= 360.0f * std::floor(theta[axis] / 360.0f);
+    auto const model = icg::scale(icg::vec3{1.0f, 1.0f, -1.0f}) * icg::rotation(icg::vec3{theta[0], theta[1], theta[2]});
+    program.set_uniform_value(model_loc, model);
 
     glDrawArrays(GL_TRIANGLES, 0, num_positions);
 }
@@ -123,17 +133,20 @@ void window::draw_ui()
     ImGui::Begin("Controls", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
 
     if (ImGui::Button("Rotate X")) {
-        axis = x_axis;
+        ui_action(rotate_control, x_axis);
     }
 
     if (ImGui::Button("Rotate Y")) {
-        axis = y_axis;
+        ui_action(rotate_control, y_axis);
     }
 
     if (ImGui::Button("Rotate Z")) {
-        axis = z_axis;
+        ui_action(rotate_control, z_axis);
     }
 
+    auto const& uniforms = program.uniform_upload_stats();
+    ImGui::Text("Uniform uploads: %zu, skipped: %zu", uniforms.issued, uniforms.skipped);
+
     ImGui::End();
 }
 
@@ -156,9 +169,8 @@ void window::quad(int a, int b, int c, int d)
     std::array indices = {a, b, c, a, c, d};
 
     for (int i : indices) {
-        positions.push_back(vertices[i]);
-        // for solid colored faces use
-        colors.push_back(vertex_colors[a]);
+        // for solid colored faces use vertex_colors[a]
+        points.push_back({vertices[i], vertex_colors[a]});
     }
 }
 
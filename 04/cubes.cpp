@@ -0,0 +1,182 @@
+#include "../main.h"
+#include "shaders.h"
+#include <icg/frame_clock.h>
+#include <icg/gl/ring_buffer.h>
+#include <icg/gl/shader_program.h>
+#include <icg/gl/vertex_layout.h>
+#include <icg/instancing.h>
+#include <tinygl/tinygl.h>
+#include <array>
+#include <chrono>
+#include <optional>
+
+constexpr int num_elements  = 36;
+constexpr std::size_t grid_side = 316;
+constexpr std::uint32_t seed = 42;
+
+// w = 1 is supplied by OpenGL for the missing fourth component of aPosition
+constexpr std::array vertices = {
+    icg::vec3{-0.5f, -0.5f,  0.5f},
+    icg::vec3{-0.5f,  0.5f,  0.5f},
+    icg::vec3{ 0.5f,  0.5f,  0.5f},
+    icg::vec3{ 0.5f, -0.5f,  0.5f},
+    icg::vec3{-0.5f, -0.5f, -0.5f},
+    icg::vec3{-0.5f,  0.5f, -0.5f},
+    icg::vec3{ 0.5f,  0.5f, -0.5f},
+    icg::vec3{ 0.5f, -0.5f, -0.5f}
+};
+
+constexpr std::array vertex_colors = {
+    icg::rgba8{  0,   0,   0, 255},  // black
+    icg::rgba8{255,   0,   0, 255},  // red
+    icg::rgba8{255, 255,   0, 255},  // yellow
+    icg::rgba8{  0, 255,   0, 255},  // green
+    icg::rgba8{  0,   0, 255, 255},  // blue
+    icg::rgba8{255,   0, 255, 255},  // magenta
+    icg::rgba8{  0, 255, 255, 255},  // cyan
+    icg::rgba8{255, 255, 255, 255}   // white
+};
+
+constexpr auto colored_vertices = [] {
+    std::array<icg::gl::colored_vertex3, vertices.size()> result{};
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        result[i] = {vertices[i], vertex_colors[i]};
+    }
+    return result;
+}();
+
+// indices of the 12 triangles that comprise the cube
+constexpr std::array<GLubyte, 36> indices = {
+    1, 0, 3,
+    3, 2, 1,
+    2, 3, 7,
+    7, 6, 2,
+    3, 0, 4,
+    4, 7, 3,
+    6, 5, 1,
+    1, 2, 6,
+    4, 5, 6,
+    6, 7, 4,
+    5, 4, 0,
+    0, 1, 5
+};
+
+// A grid of independently rotating cubes drawn with one instanced call. The
+// cube's vertex and index buffers are shared by all instances; their model
+// matrices come from a per-instance attribute buffer refilled every frame.
+class window : public tinygl::window
+{
+public:
+    using tinygl::window::window;
+    void init() override;
+    void process_input() override;
+    void draw() override;
+    void draw_ui() override;
+private:
+    void create_instance_buffer(std::size_t num_regions);
+    void set_model_attribute(std::size_t first);
+
+    icg::gl::shader_program program;
+    tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
+    tinygl::buffer i_buffer{tinygl::buffer::type::index_buffer, tinygl::buffer::usage_pattern::static_draw};
+    tinygl::buffer m_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::stream_draw};
+    tinygl::vertex_array_object vao;
+
+    icg::instance_motion motion{icg::instance_grid(grid_side, seed)};
+    std::optional<icg::gl::ring_buffer<icg::mat4>> transforms;
+    int num_regions{3};
+    int model_loc{-1};
+
+    icg::frame_clock clock;
+    float fill_ms{0.0f};
+};
+
+void window::init()
+{
+    // Configure OpenGL.
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glEnable(GL_DEPTH_TEST);
+
+    // Load shaders and initialize attribute buffers.
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::cubes_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::cube_frag);
+    program.link();
+    program.use();
+
+    // Load the data into the GPU
+    vao.bind();
+
+    // array element buffer
+    i_buffer.bind();
+    i_buffer.create(indices.begin(), indices.end());
+
+    // interleaved position and color attribute buffer
+    v_buffer.bind();
+    v_buffer.create(colored_vertices.begin(), colored_vertices.end());
+    icg::gl::set_vertex_layout<icg::gl::colored_vertex3>(vao, program);
+
+    // per-instance model matrices, a mat4 attribute takes four locations
+    model_loc = program.attribute_location("aModel");
+    for (int c = 0; c < 4; ++c) {
+        vao.enable_attribute_array(model_loc + c);
+        glVertexAttribDivisor(static_cast<GLuint>(model_loc + c), 1);
+    }
+    create_instance_buffer(static_cast<std::size_t>(num_regions));
+}
+
+void window::process_input()
+{
+    if (get_key(tinygl::keyboard::key::escape) == tinygl::keyboard::key_state::press) {
+        set_should_close(true);
+    }
+}
+
+void window::draw()
+{
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    clock.tick();
+    auto const seconds = static_cast<float>(clock.elapsed());
+    {
+        auto const range = transforms->map_next();
+        auto const fill_start = std::chrono::steady_clock::now();
+        icg::fill_instance_transforms(motion, seconds, range.span());
+        fill_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - fill_start).count();
+    }
+    set_model_attribute(transforms->first());
+
+    glDrawElementsInstanced(GL_TRIANGLES, num_elements, GL_UNSIGNED_BYTE, 0, static_cast<GLsizei>(motion.size()));
+    transforms->fence();
+}
+
+void window::draw_ui()
+{
+    ImGui::Begin("Controls", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+    ImGui::Text("Cubes: %zu", motion.size());
+    if (ImGui::SliderInt("Instance buffers", &num_regions, 1, 3)) {
+        create_instance_buffer(static_cast<std::size_t>(num_regions));
+    }
+    auto const& stats = transforms->stats();
+    ImGui::Text("Fill: %.2f ms, stalls: %zu of %zu frames", fill_ms, stats.stalls, stats.frames);
+
+    ImGui::End();
+}
+
+void window::create_instance_buffer(std::size_t num_regions)
+{
+    transforms.reset();
+    transforms.emplace(m_buffer, motion.size(), num_regions);
+    transforms->create();
+}
+
+void window::set_model_attribute(std::size_t first)
+{
+    vao.bind();
+    m_buffer.bind();
+    for (int c = 0; c < 4; ++c) {
+        vao.set_attribute_array(model_loc + c, 4, GL_FLOAT, GL_FALSE, sizeof(icg::mat4), sizeof(icg::mat4) * first + sizeof(float) * 4 * c);
+    }
+}
+
+MAIN
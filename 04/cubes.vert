@@ -0,0 +1,14 @@
+#version 330
+
+in vec4 aPosition;
+in vec4 aColor;
+out vec4 vColor;
+
+// Model matrix of the instance, z flip included, advanced once per instance.
+in mat4 aModel;
+
+void main()
+{
+    vColor = aColor;
+    gl_Position = aModel * aPosition;
+}
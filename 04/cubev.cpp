@@ -1,34 +1,56 @@
 #include "../main.h"
+#include "shaders.h"
+#include <icg/frame_clock.h>
+#include <icg/gl/input_window.h>
+#include <icg/gl/shader_program.h>
+#include <icg/gl/vertex_layout.h>
+#include <icg/transform.h>
 #include <tinygl/tinygl.h>
 #include <array>
+#include <cmath>
 
 constexpr int num_elements  = 36;
 constexpr int x_axis = 0;
 constexpr int y_axis = 1;
 constexpr int z_axis = 2;
 
+// The UI control recorded with an input_window, set to the axis to rotate about.
+constexpr int rotate_control = 0;
+
+// degrees per second, what 2 per frame was at 60 Hz
+constexpr float angular_velocity = 120.0f;
+
+// w = 1 is supplied by OpenGL for the missing fourth component of aPosition
 constexpr std::array vertices = {
-    tinyla::vec4f{-0.5f, -0.5f,  0.5f, 1.0f},
-    tinyla::vec4f{-0.5f,  0.5f,  0.5f, 1.0f},
-    tinyla::vec4f{ 0.5f,  0.5f,  0.5f, 1.0f},
-    tinyla::vec4f{ 0.5f, -0.5f,  0.5f, 1.0f},
-    tinyla::vec4f{-0.5f, -0.5f, -0.5f, 1.0f},
-    tinyla::vec4f{-0.5f,  0.5f, -0.5f, 1.0f},
-    tinyla::vec4f{ 0.5f,  0.5f, -0.5f, 1.0f},
-    tinyla::vec4f{ 0.5f, -0.5f, -0.5f, 1.0f}
+    icg::vec3{-0.5f, -0.5f,  0.5f},
+    icg::vec3{-0.5f,  0.5f,  0.5f},
+    icg::vec3{ 0.5f,  0.5f,  0.5f},
+    icg::vec3{ 0.5f, -0.5f,  0.5f},
+    icg::vec3{-0.5f, -0.5f, -0.5f},
+    icg::vec3{-0.5f,  0.5f, -0.5f},
+    icg::vec3{ 0.5f,  0.5f, -0.5f},
+    icg::vec3{ 0.5f, -0.5f, -0.5f}
 };
 
 constexpr std::array vertex_colors = {
-    tinyla::vec4f{0.0f, 0.0f, 0.0f, 1.0f},  // black
-    tinyla::vec4f{1.0f, 0.0f, 0.0f, 1.0f},  // red
-    tinyla::vec4f{1.0f, 1.0f, 0.0f, 1.0f},  // yellow
-    tinyla::vec4f{0.0f, 1.0f, 0.0f, 1.0f},  // green
-    tinyla::vec4f{0.0f, 0.0f, 1.0f, 1.0f},  // blue
-    tinyla::vec4f{1.0f, 0.0f, 1.0f, 1.0f},  // magenta
-    tinyla::vec4f{0.0f, 1.0f, 1.0f, 1.0f},  // cyan
-    tinyla::vec4f{1.0f, 1.0f, 1.0f, 1.0f}   // white
+    icg::rgba8{  0,   0,   0, 255},  // black
+    icg::rgba8{255,   0,   0, 255},  // red
+    icg::rgba8{255, 255,   0, 255},  // yellow
+    icg::rgba8{  0, 255,   0, 255},  // green
+    icg::rgba8{  0,   0, 255, 255},  // blue
+    icg::rgba8{255,   0, 255, 255},  // magenta
+    icg::rgba8{  0, 255, 255, 255},  // cyan
+    icg::rgba8{255, 255, 255, 255}   // white
 };
 
+constexpr auto colored_vertices = [] {
+    std::array<icg::gl::colored_vertex3, vertices.size()> result{};
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        result[i] = {vertices[i], vertex_colors[i]};
+    }
+    return result;
+}();
+
 // indices of the 12 triangles that comprise the cube
 constexpr std::array<GLubyte, 36> indices = {
     1, 0, 3,
@@ -45,24 +67,24 @@ constexpr std::array<GLubyte, 36> indices = {
     0, 1, 5
 };
 
-class window final : public tinygl::window
+class window : public icg::gl::input_window
 {
 public:
-    using tinygl::window::window;
+    using icg::gl::input_window::input_window;
     void init() override;
     void process_input() override;
     void draw() override;
     void draw_ui() override;
 private:
-    tinygl::shader_program program;
+    icg::gl::shader_program program;
     tinygl::buffer v_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
-    tinygl::buffer c_buffer{tinygl::buffer::type::vertex_buffer, tinygl::buffer::usage_pattern::static_draw};
     tinygl::buffer i_buffer{tinygl::buffer::type::index_buffer, tinygl::buffer::usage_pattern::static_draw};
     tinygl::vertex_array_object vao;
 
+    icg::frame_clock clock;
     tinyla::vec3f theta{0.0f, 0.0f, 0.0f};
     int axis = 0;
-    int theta_loc{-1};
+    int model_loc{-1};
 };
 
 void window::init()
@@ -73,8 +95,8 @@ void window::init()
     glEnable(GL_DEPTH_TEST);
 
     // Load shaders and initialize attribute buffers.
-    program.add_shader_from_source_file(tinygl::shader::type::vertex, "cube.vert");
-    program.add_shader_from_source_file(tinygl::shader::type::fragment, "cube.frag");
+    program.add_shader_from_source(tinygl::shader::type::vertex, shaders::cube_vert);
+    program.add_shader_from_source(tinygl::shader::type::fragment, shaders::cube_frag);
     program.link();
     program.use();
 
@@ -85,23 +107,16 @@ void window::init()
     i_buffer.bind();
     i_buffer.create(indices.begin(), indices.end());
 
-    // color array atrribute buffer
-    c_buffer.bind();
-    c_buffer.create(vertex_colors.begin(), vertex_colors.end());
-
-    auto colorLoc = program.attribute_location("aColor");
-    vao.set_attribute_array(colorLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(colorLoc);
-
-    // vertex array attribute buffer
+    // interleaved position and color attribute buffer
     v_buffer.bind();
-    v_buffer.create(vertices.begin(), vertices.end());
+    v_buffer.create(colored_vertices.begin(), colored_vertices.end());
+    icg::gl::set_vertex_layout<icg::gl::colored_vertex3>(vao, program);
 
-    auto positionLoc = program.attribute_location("aPosition");
-    vao.set_attribute_array(positionLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
-    vao.enable_attribute_array(positionLoc);
+    model_loc = program.uniform_location("uModel");
 
-    theta_loc = program.uniform_location("uTheta");
+    set_ui_callback([this](std::int32_t /*control*/, std::int32_t value) {
+        axis = value;
+    });
 
     set_key_callback([this](tinygl::keyboard::key key, int /*scancode*/, tinygl::input::action action, tinygl::input::modifier /*mods*/) {
         if (key == tinygl::keyboard::key::x && action == tinygl::input::action::press) {
@@ -127,8 +142,11 @@ void window::draw()
 {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    theta[axis] += 2.0f;
-    program.set_uniform_value(theta_loc, theta);
+    // kept in [0, 360), where icg::rotation's sine and cosine are accurate
+    theta[axis] += angular_velocity * clock.tick();
+    theta[axis] -= 360.0f * std::floor(theta[axis] / 360.0f);
+    auto const model = icg::scale(icg::vec3{1.0f, 1.0f, -1.0f}) * icg::rotation(icg::vec3{theta[0], theta[1], theta[2]});
+    program.set_uniform_value(model_loc, model);
 
     glDrawElements(GL_TRIANGLES, num_elements, GL_UNSIGNED_BYTE, 0);
 }
@@ -138,17 +156,20 @@ void window::draw_ui()
     ImGui::Begin("Controls", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
 
     if (ImGui::Button("Rotate X")) {
-        axis = x_axis;
+        ui_action(rotate_control, x_axis);
     }
 
     if (ImGui::Button("Rotate Y")) {
-        axis = y_axis;
+        ui_action(rotate_control, y_axis);
     }
 
     if (ImGui::Button("Rotate Z")) {
-        axis = z_axis;
+        ui_action(rotate_control, z_axis);
     }
 
+    auto const& uniforms = program.uniform_upload_stats();
+    ImGui::Text("Uniform uploads: %zu, skipped: %zu", uniforms.issued, uniforms.skipped);
+
     ImGui::End();
 }
 
@@ -0,0 +1,1118 @@
+#include <icg/chaos_game.h>
+#include <icg/chaos_game_chains.h>
+#include <icg/color.h>
+#include <icg/density.h>
+#include <icg/dirty_ranges.h>
+#include <icg/draw_batch.h>
+#include <icg/frame_writer.h>
+#include <icg/free_list.h>
+#include <icg/geometry_cache.h>
+#include <icg/growable_storage.h>
+#include <icg/ifs.h>
+#include <icg/input_log.h>
+#include <icg/instancing.h>
+#include <icg/memory.h>
+#include <icg/parallel.h>
+#include <icg/profiler.h>
+#include <icg/progressive_chaos_game.h>
+#include <icg/program_cache.h>
+#include <icg/random.h>
+#include <icg/simd.h>
+#include <icg/soft/rasterizer.h>
+#include <icg/shapes.h>
+#include <icg/subdivision.h>
+#include <icg/transform.h>
+#include <icg/uniform_shadow.h>
+#include <fmt/core.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t seed = 42;
+
+// Beyond this many points only the streaming generators run, since keeping
+// 10^9 points in memory takes 8 to 12 GiB.
+constexpr std::size_t max_in_memory_size = 100'000'000;
+
+// Keeps the generated geometry observable so that it is not optimized away.
+volatile float sink = 0.0f;
+
+// Set by every check that fails, so that the run fails as a whole.
+bool failed = false;
+
+// " MISMATCH" to append to the label of a check unless it passed.
+const char* mismatch_unless(bool ok)
+{
+    failed = failed || !ok;
+    return ok ? "" : " MISMATCH";
+}
+
+template <typename F>
+double time_seconds(F&& f)
+{
+    auto const start = std::chrono::steady_clock::now();
+    f();
+    auto const stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+void report(const std::string& name, std::size_t size, const char* unit, double seconds)
+{
+    fmt::print("{:<24} {:>12} {:<9} {:>10.4f} s {:>14.0f} {}/s\n", name, size, unit, seconds, size / seconds, unit);
+}
+
+void report_memory(const std::string& name, std::size_t data_bytes)
+{
+    fmt::print("{:<24} {:>12} MiB data {:>10} MiB peak resident\n", name, data_bytes >> 20, icg::peak_resident_bytes() >> 20);
+}
+
+// Order-dependent hash of the bytes of `data`, used to compare outputs
+// without keeping a second copy of them around.
+template <typename T>
+std::uint64_t fingerprint(std::span<const T> data)
+{
+    auto const bytes = std::as_bytes(data);
+    auto hash = std::uint64_t{0xcbf29ce484222325};
+    auto i = std::size_t{0};
+    for (; i + sizeof(std::uint64_t) <= bytes.size(); i += sizeof(std::uint64_t)) {
+        auto word = std::uint64_t{};
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3;
+    }
+    for (; i < bytes.size(); ++i) {
+        hash = (hash ^ static_cast<std::uint64_t>(bytes[i])) * 0x100000001b3;
+    }
+    return hash;
+}
+
+template <typename Vec, std::size_t N>
+void bench_parallel_chaos_game(const std::string& name, const std::array<Vec, N>& vertices, std::size_t size)
+{
+    auto const max_threads = icg::resolve_num_threads(0);
+    auto const max_level = icg::detect_simd_level();
+    auto positions = std::vector<Vec>(size);
+    auto reference = std::uint64_t{};
+    auto run = [&](unsigned threads, icg::simd_level level) {
+        auto const seconds = time_seconds([&] {
+            icg::parallel_chaos_game(vertices, std::span{positions}, seed, threads, level);
+        });
+        auto const hash = fingerprint(std::span<const Vec>{positions});
+        if (threads == 1 && level == icg::simd_level::scalar) {
+            reference = hash;
+        }
+        auto const label = fmt::format("{} {} t={}{}", name, icg::name(level), threads, mismatch_unless(hash == reference));
+        report(label, size, "points", seconds);
+    };
+
+    // SIMD levels on one thread, then thread scaling at the best level.
+    for (auto level = icg::simd_level::scalar; level <= max_level; level = static_cast<icg::simd_level>(static_cast<int>(level) + 1)) {
+        run(1, level);
+    }
+    for (unsigned threads = 2; threads <= max_threads; threads = threads == max_threads ? threads + 1 : std::min(2 * threads, max_threads)) {
+        run(threads, max_level);
+    }
+
+    // Structure of arrays, interleaved afterwards as it would be on upload.
+    auto points = icg::soa_points{};
+    points.x.resize(size);
+    points.y.resize(size);
+    if constexpr (sizeof(Vec) == sizeof(icg::vec3)) {
+        points.z.resize(size);
+    }
+    auto const generate = time_seconds([&] {
+        icg::parallel_chaos_game(vertices, points, seed, max_threads, max_level);
+    });
+    auto const interleave = time_seconds([&] {
+        icg::interleave(points, std::span{positions});
+    });
+    auto const hash = fingerprint(std::span<const Vec>{positions});
+    report(fmt::format("{} soa{}", name, mismatch_unless(hash == reference)), size, "points", generate);
+    report(fmt::format("{} interleave", name), size, "points", interleave);
+}
+
+// Streams the points through a single chunk-sized buffer, the way they are
+// streamed into mapped vertex buffer ranges, so the resident set stays
+// bounded by the chunk size no matter how many points are generated.
+template <typename Vec, std::size_t N>
+void bench_chaos_game_stream(const std::string& name, const std::array<Vec, N>& vertices, std::size_t size)
+{
+    auto chunk = std::vector<Vec>(std::min(size, icg::chaos_game_chunk_size));
+    icg::reset_peak_resident_bytes();
+    auto const seconds = time_seconds([&] {
+        auto stream = icg::chaos_game_stream(vertices, size, seed);
+        while (stream.next_chunk_size() > 0) {
+            stream.generate(chunk);
+            sink = chunk.front().x;
+        }
+    });
+    report(name, size, "points", seconds);
+    report_memory(name, sizeof(Vec) * size);
+}
+
+// The positions on the Weyl sequence where the chains of 10^9 points start,
+// for a few seeds: no two may lie within the numbers a chain draws of each
+// other, or the two chains would repeat each other's points.
+void bench_counter_rng_streams()
+{
+    constexpr auto size = std::size_t{1'000'000'000};
+    constexpr auto chain_numbers = icg::chaos_game_chain_length + icg::chaos_game_burn_in;
+    auto const num_chains = (size + icg::chaos_game_chain_length - 1) / icg::chaos_game_chain_length;
+    for (auto const s : {std::uint32_t{1}, seed, std::uint32_t{12345}}) {
+        auto positions = std::vector<std::uint32_t>(num_chains);
+        for (std::size_t c = 0; c < num_chains; ++c) {
+            positions[c] = icg::counter_rng::stream(s, c).position();
+        }
+        std::ranges::sort(positions);
+        // the gap from the last position wraps around to the first
+        auto min_gap = positions.front() - positions.back();
+        for (std::size_t c = 1; c < num_chains; ++c) {
+            min_gap = std::min(min_gap, positions[c] - positions[c - 1]);
+        }
+        fmt::print("counter_rng seed={} {} chains, closest {} numbers apart{}\n",
+            s, num_chains, min_gap, mismatch_unless(min_gap >= chain_numbers));
+    }
+}
+
+void bench_chaos_game(int max_exponent)
+{
+    auto size = std::size_t{1};
+    for (int e = 0; e <= max_exponent; ++e, size *= 10) {
+        if (e < 3) {
+            continue;
+        }
+        if (size <= max_in_memory_size) {
+            {
+                auto const seconds = time_seconds([&] {
+                    auto const positions = icg::chaos_game(icg::gasket_triangle, icg::vec2{0.0f, 0.0f}, size, seed);
+                    sink = positions.back().x;
+                });
+                report("chaos_game 2d", size, "points", seconds);
+            }
+            {
+                auto const seconds = time_seconds([&] {
+                    auto const positions = icg::chaos_game(icg::gasket_tetrahedron, icg::vec3{0.0f, 0.0f, 0.0f}, size, seed);
+                    sink = positions.back().x;
+                });
+                report("chaos_game 3d", size, "points", seconds);
+            }
+            icg::reset_peak_resident_bytes();
+            bench_parallel_chaos_game("parallel 2d", icg::gasket_triangle, size);
+            report_memory("parallel 2d", sizeof(icg::vec2) * size);
+            icg::reset_peak_resident_bytes();
+            bench_parallel_chaos_game("parallel 3d", icg::gasket_tetrahedron, size);
+            report_memory("parallel 3d", sizeof(icg::vec3) * size);
+        }
+        bench_chaos_game_stream("stream 2d", icg::gasket_triangle, size);
+        bench_chaos_game_stream("stream 3d", icg::gasket_tetrahedron, size);
+    }
+}
+
+// The progressive chaos game consumed as a window does, chunk by chunk as the
+// worker thread delivers them: the time until the first chunk, which bounds
+// the time to the first frame, against the time for all points. Concatenated,
+// the chunks must match the points parallel_chaos_game generates at once.
+void bench_progressive_chaos_game(int max_exponent)
+{
+    auto size = std::size_t{1};
+    for (int e = 0; e < std::min(max_exponent, 8); ++e) {
+        size *= 10;
+    }
+    auto const reference = fingerprint(std::span<const icg::vec2>{icg::parallel_chaos_game(icg::gasket_triangle, size, seed)});
+
+    auto positions = std::vector<icg::vec2>(size);
+    auto stats = icg::progressive_stats{};
+    auto const seconds = time_seconds([&] {
+        auto generator = icg::progressive_chaos_game{icg::gasket_triangle, size, seed};
+        while (!generator.done()) {
+            auto const count = generator.consume(std::chrono::milliseconds{4}, [&](std::size_t first, std::span<const icg::vec2> points) {
+                std::ranges::copy(points, positions.begin() + static_cast<std::ptrdiff_t>(first));
+            });
+            if (count == 0) {
+                std::this_thread::yield();
+            }
+        }
+        stats = generator.stats();
+    });
+    auto const hash = fingerprint(std::span<const icg::vec2>{positions});
+    report(fmt::format("progressive 2d{}", mismatch_unless(hash == reference)), size, "points", seconds);
+    fmt::print("    first chunk after {:.2f} ms, {:.0f} points/s\n", 1e3 * stats.first_chunk_seconds, stats.fill_rate());
+}
+
+// The CPU reference of the transform feedback engine against the chains of
+// parallel_chaos_game, which it must reproduce bit for bit.
+void bench_chaos_game_chains(int max_exponent)
+{
+    auto const num_chains = max_exponent < 6 ? std::size_t{4} : std::size_t{16};
+    auto const steps = icg::chaos_game_chain_length;
+    auto const size = num_chains * steps;
+    auto const chains = icg::parallel_chaos_game(icg::gasket_tetrahedron, size, seed);
+
+    auto positions = std::vector<icg::vec3>{};
+    auto const seconds = time_seconds([&] {
+        positions = icg::chaos_game_chains(icg::gasket_tetrahedron, num_chains, steps, seed);
+    });
+    auto mismatches = std::size_t{0};
+    for (std::size_t c = 0; c < num_chains; ++c) {
+        for (std::size_t k = 0; k < steps; ++k) {
+            mismatches += std::memcmp(&positions[k * num_chains + c], &chains[c * steps + k], sizeof(icg::vec3)) != 0;
+        }
+    }
+    report(fmt::format("chains 3d{}", mismatch_unless(mismatches == 0)), size, "points", seconds);
+}
+
+// One configuration of the IFS engine at every SIMD level, checked against
+// the scalar kernel or, for the gaskets, against parallel_chaos_game. The
+// digit after the name is the dimension.
+template <int D>
+void bench_ifs(const std::string& name, const icg::ifs<D>& system, std::size_t size, std::optional<std::uint64_t> expected = {})
+{
+    using Vec = std::conditional_t<D == 2, icg::vec2, icg::vec3>;
+    auto const max_threads = icg::resolve_num_threads(0);
+    auto const max_level = icg::detect_simd_level();
+    auto positions = std::vector<Vec>(size);
+    auto reference = expected;
+    auto run = [&](unsigned threads, icg::simd_level level) {
+        auto const seconds = time_seconds([&] {
+            icg::parallel_ifs(system, std::span{positions}, seed, threads, level);
+        });
+        auto const hash = fingerprint(std::span<const Vec>{positions});
+        if (!reference) {
+            reference = hash;
+        }
+        auto const label = fmt::format("{} {} t={}{}", name, icg::name(level), threads, mismatch_unless(hash == reference));
+        report(label, size, "points", seconds);
+    };
+    for (auto level = icg::simd_level::scalar; level <= max_level; level = static_cast<icg::simd_level>(static_cast<int>(level) + 1)) {
+        run(1, level);
+    }
+    if (max_threads > 1) {
+        run(max_threads, max_level);
+    }
+}
+
+void bench_ifs(int max_exponent)
+{
+    auto size = std::size_t{1};
+    for (int e = 0; e < std::min(max_exponent, 7); ++e) {
+        size *= 10;
+    }
+    auto const gasket2 = fingerprint(std::span<const icg::vec2>{icg::parallel_chaos_game(icg::gasket_triangle, size, seed)});
+    auto const gasket3 = fingerprint(std::span<const icg::vec3>{icg::parallel_chaos_game(icg::gasket_tetrahedron, size, seed)});
+    bench_ifs("ifs gasket2", icg::gasket_ifs(icg::gasket_triangle), size, gasket2);
+    bench_ifs("ifs gasket3", icg::gasket_ifs(icg::gasket_tetrahedron), size, gasket3);
+    bench_ifs("ifs dragon2", icg::heighway_dragon(), size);
+    bench_ifs("ifs fern2", icg::barnsley_fern(), size);
+    bench_ifs("ifs carpet2", icg::sierpinski_carpet(), size);
+    bench_ifs("ifs pyramid3", icg::sierpinski_pyramid(), size);
+    bench_ifs("ifs dust3", icg::cantor_dust(), size);
+}
+
+// Bins the gaskets into density grids while generating them, at one and
+// several threads, against binning the stored point cloud.
+template <typename Vec, std::size_t N>
+void bench_density(const std::string& name, const std::array<Vec, N>& vertices, std::size_t size, const icg::density_grid& grid)
+{
+    auto const reference = icg::bin_points(std::span<const Vec>{icg::parallel_chaos_game(vertices, size, seed)}, grid);
+    for (unsigned threads : {1u, 4u}) {
+        icg::reset_peak_resident_bytes();
+        auto result = icg::density{};
+        auto const seconds = time_seconds([&] {
+            result = icg::chaos_game_density(vertices, size, seed, grid, threads);
+        });
+        auto const match = result.counts == reference.counts && result.max_count == reference.max_count && result.total == reference.total;
+        report(fmt::format("{} t={}{}", name, threads, mismatch_unless(match)), size, "points", seconds);
+        fmt::print("    {} bins, {} points binned, {} at most per bin, {} MiB peak resident\n",
+            grid.size(), result.total, result.max_count, icg::peak_resident_bytes() >> 20);
+    }
+}
+
+void bench_density(int max_exponent)
+{
+    auto size = std::size_t{1};
+    for (int e = 0; e < std::min(max_exponent, 7); ++e) {
+        size *= 10;
+    }
+    bench_density("density 2d", icg::gasket_triangle, size, {{-1.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, 512, 512});
+    bench_density("density 3d", icg::gasket_tetrahedron, size, {{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}, 128, 128, 128});
+}
+
+// A vertex as gasket4 uploads it, the color packed into four bytes.
+struct packed_vertex3
+{
+    icg::vec3 position;
+    icg::rgba8 color;
+};
+
+void report_reduction(const icg::mesh_reduction& r)
+{
+    fmt::print("    {} vertices instead of {} ({:.1f}%), {} bytes instead of {} ({:.1f}%){}\n",
+        r.indexed_vertices, r.flat_vertices, 100.0 * r.indexed_vertices / r.flat_vertices,
+        r.indexed_bytes, r.flat_bytes, 100.0 * r.indexed_bytes / r.flat_bytes,
+        r.saves() ? "" : ", indexing does not help");
+}
+
+void bench_subdivision(int max_exponent)
+{
+    auto max_size = std::size_t{1};
+    for (int e = 0; e < max_exponent; ++e) {
+        max_size *= 10;
+    }
+    auto const max_threads = icg::resolve_num_threads(0);
+
+    // 3^n triangles after n subdivisions of a triangle
+    auto const& t = icg::gasket_triangle;
+    for (int count = 0; icg::divide_triangle_size(count) / 3 <= max_size; ++count) {
+        auto const size = icg::divide_triangle_size(count);
+        if (size / 3 < 1000 || size > max_in_memory_size) {
+            continue;
+        }
+        auto positions = std::vector<icg::vec2>(size);
+        for (auto threads : {1u, max_threads}) {
+            auto const seconds = time_seconds([&] {
+                icg::divide_triangle(t[0], t[1], t[2], count, positions, threads);
+            });
+            sink = positions.back().x;
+            report(fmt::format("divide_triangle n={} t={}", count, threads), size / 3, "triangles", seconds);
+            if (max_threads == 1) {
+                break;
+            }
+        }
+        auto mesh = icg::indexed_triangles<icg::vec2>{};
+        auto const seconds = time_seconds([&] {
+            mesh = icg::divide_triangle_indexed(t[0], t[1], t[2], count);
+        });
+        report(fmt::format("divide_triangle_indexed n={}", count), size / 3, "triangles", seconds);
+        report_reduction(icg::reduction<icg::vec2>(mesh));
+    }
+
+    // 4 * 4^n triangles after n subdivisions of a tetrahedron
+    auto const& v = icg::gasket_regular_tetrahedron;
+    for (int count = 0; icg::divide_tetra_size(count) / 3 <= max_size; ++count) {
+        auto const size = icg::divide_tetra_size(count);
+        if (size / 3 < 1000 || size > max_in_memory_size) {
+            continue;
+        }
+        auto positions = std::vector<icg::vec3>(size);
+        auto colors = std::vector<icg::vec3>(size);
+        for (auto threads : {1u, max_threads}) {
+            auto const seconds = time_seconds([&] {
+                icg::divide_tetra(v[0], v[1], v[2], v[3], count, positions, colors, threads);
+            });
+            sink = positions.back().x;
+            report(fmt::format("divide_tetra n={} t={}", count, threads), size / 3, "triangles", seconds);
+            if (max_threads == 1) {
+                break;
+            }
+        }
+        auto mesh = icg::indexed_triangles<icg::vec3>{};
+        auto const seconds = time_seconds([&] {
+            mesh = icg::divide_tetra_indexed(v[0], v[1], v[2], v[3], count);
+        });
+        report(fmt::format("divide_tetra_indexed n={}", count), size / 3, "triangles", seconds);
+        report_reduction(icg::reduction<packed_vertex3>(mesh));
+    }
+}
+
+// Input replayed at increasing rates: every event appends a rectangle of four
+// vertices, as in cad1, and recolors one earlier vertex. The number of buffer
+// updates per frame is the number of merged ranges left at the end of it.
+void bench_dirty_ranges(int max_exponent)
+{
+    auto max_events = std::size_t{1};
+    for (int e = 0; e < std::min(max_exponent, 6); ++e) {
+        max_events *= 10;
+    }
+
+    for (std::size_t events = 1; events <= max_events; events *= 10) {
+        auto dirty = icg::dirty_ranges{};
+        auto const seconds = time_seconds([&] {
+            for (std::size_t i = 0; i < events; ++i) {
+                dirty.add(4 * i, 4 * i + 4);
+                dirty.add(2 * i, 2 * i + 1);
+            }
+        });
+        report(fmt::format("dirty_ranges e={}", events), 2 * events, "edits", seconds);
+        // the edits touch or overlap each other, so they coalesce into one
+        fmt::print("    {} updates per frame instead of {}{}\n", dirty.ranges().size(), 2 * events, mismatch_unless(dirty.ranges().size() == 1));
+    }
+}
+
+// CAD sessions of increasing length: every event appends a rectangle of four
+// vertices to storage with no capacity reserved up front. Afterwards every
+// other rectangle is deleted and as many drawn again, which must all land in
+// the released blocks rather than grow the storage.
+void bench_growable_storage(int max_exponent)
+{
+    auto max_events = std::size_t{1};
+    for (int e = 0; e < std::min(max_exponent, 7); ++e) {
+        max_events *= 10;
+    }
+
+    auto const rectangle = std::array<icg::vec2, 4>{};
+    for (std::size_t events = 1000; events <= max_events; events *= 10) {
+        auto storage = icg::growable_storage<icg::vec2>{};
+        auto const append = time_seconds([&] {
+            for (std::size_t i = 0; i < events; ++i) {
+                storage.append(rectangle);
+            }
+        });
+        report(fmt::format("growable_storage e={}", events), events, "appends", append);
+        auto const& growth = storage.stats();
+        fmt::print("    {} reallocations, {:.2f} elements copied per element\n",
+            growth.reallocations, static_cast<double>(growth.elements_copied) / storage.size());
+
+        auto const size = storage.size();
+        auto const reuse = time_seconds([&] {
+            for (std::size_t i = 0; i < events; i += 2) {
+                storage.release(4 * i, 4);
+            }
+            for (std::size_t i = 0; i < events; i += 2) {
+                storage.store(rectangle);
+            }
+        });
+        report(fmt::format("growable_storage reuse e={}", events), events, "edits", reuse);
+        if (storage.size() != size || storage.num_released() != 0) {
+            failed = true;
+            fmt::print("    MISMATCH: released blocks not reused\n");
+        }
+    }
+
+    // released neighbors merge into a block a larger primitive fits in, and
+    // releasing an element that is free already is refused
+    auto list = icg::free_list{};
+    list.release(0, 4);
+    list.release(8, 4);
+    list.release(4, 4);
+    auto const merged = list.num_blocks() == 1 && list.allocate(12) == std::size_t{0} && list.size() == 0;
+    list.release(0, 4);
+    auto rejected = false;
+    try {
+        list.release(2, 4);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    if (!merged || !rejected || list.size() != 4) {
+        failed = true;
+        fmt::print("    MISMATCH: free blocks merged {}, overlapping release rejected {}\n", merged, rejected);
+    }
+}
+
+// Batches of rectangles as cad1 draws them, one triangle fan of four vertices
+// each, added one at a time as they are drawn.
+void bench_draw_batch(int max_exponent)
+{
+    auto max_shapes = std::size_t{1};
+    for (int e = 0; e < std::min(max_exponent, 7); ++e) {
+        max_shapes *= 10;
+    }
+
+    for (std::size_t shapes = 1000; shapes <= max_shapes; shapes *= 10) {
+        auto batch = icg::draw_batch{};
+        auto const seconds = time_seconds([&] {
+            for (std::size_t i = 0; i < shapes; ++i) {
+                batch.add(4 * i, 4);
+            }
+        });
+        report(fmt::format("draw_batch s={}", shapes), shapes, "shapes", seconds);
+        fmt::print("    1 draw call per frame instead of {}\n", batch.size());
+    }
+
+    // vertices a GLint cannot address are refused rather than wrapped around
+    auto batch = icg::draw_batch{};
+    auto refused = false;
+    try {
+        batch.add(std::size_t{1} << 31, 4);
+    } catch (const std::length_error&) {
+        refused = true;
+    }
+    if (!refused || !batch.empty()) {
+        failed = true;
+        fmt::print("    MISMATCH: a first vertex past 2^31 - 1 was added to the batch\n");
+    }
+}
+
+// What cube.vert used to compute for every vertex: gl_Position of `p`
+// rotated by theta degrees, with std::sin/std::cos standing in for the GLSL
+// built-ins and radians() scaling by pi/180 as GLSL defines it.
+icg::vec4 shader_rotation(const icg::vec3& theta, const icg::vec4& p)
+{
+    auto const radians = [](float degrees) { return (3.14159265358979323846f / 180.0f) * degrees; };
+    auto const c = icg::vec3{std::cos(radians(theta.x)), std::cos(radians(theta.y)), std::cos(radians(theta.z))};
+    auto const s = icg::vec3{std::sin(radians(theta.x)), std::sin(radians(theta.y)), std::sin(radians(theta.z))};
+    auto const rx = icg::mat4{{1, 0, 0, 0, 0, c.x, s.x, 0, 0, -s.x, c.x, 0, 0, 0, 0, 1}};
+    auto const ry = icg::mat4{{c.y, 0, -s.y, 0, 0, 1, 0, 0, s.y, 0, c.y, 0, 0, 0, 0, 1}};
+    auto const rz = icg::mat4{{c.z, s.z, 0, 0, -s.z, c.z, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+    auto position = rz * (ry * (rx * p));
+    position.z = -position.z;
+    return position;
+}
+
+// The cube transform per frame: once per vertex as cube.vert did it, against
+// one model matrix built on the CPU and applied to every vertex. The two must
+// agree to 1e-6 over a sweep of angles.
+void bench_transform(int max_exponent)
+{
+    auto frames = std::size_t{1};
+    for (int e = 0; e < std::min(max_exponent, 6); ++e) {
+        frames *= 10;
+    }
+    constexpr auto num_vertices = std::size_t{36};
+    auto const corner = icg::vec4{0.5f, -0.5f, 0.5f, 1.0f};
+    auto const flip_z = icg::scale(icg::vec3{1.0f, 1.0f, -1.0f});
+    auto const theta_of = [](std::size_t frame) {
+        auto const t = static_cast<float>(frame % 3600);
+        return icg::vec3{2.0f * t, 0.5f * t, 0.1f * t};
+    };
+
+    auto max_error = 0.0f;
+    auto const per_vertex = time_seconds([&] {
+        for (std::size_t f = 0; f < frames; ++f) {
+            for (std::size_t v = 0; v < num_vertices; ++v) {
+                sink = shader_rotation(theta_of(f), corner).x;
+            }
+        }
+    });
+    auto const per_frame = time_seconds([&] {
+        for (std::size_t f = 0; f < frames; ++f) {
+            auto const model = flip_z * icg::rotation(theta_of(f));
+            for (std::size_t v = 0; v < num_vertices; ++v) {
+                sink = (model * corner).x;
+            }
+        }
+    });
+    for (std::size_t f = 0; f < frames; ++f) {
+        auto const expected = shader_rotation(theta_of(f), corner);
+        auto const actual = flip_z * icg::rotation(theta_of(f)) * corner;
+        max_error = std::max({max_error,
+            std::abs(actual.x - expected.x), std::abs(actual.y - expected.y),
+            std::abs(actual.z - expected.z), std::abs(actual.w - expected.w)});
+    }
+    report("transform per vertex", frames, "frames", per_vertex);
+    report(fmt::format("transform per frame{}", mismatch_unless(max_error <= 1e-6f)), frames, "frames", per_frame);
+    fmt::print("    max difference {:.2e}\n", max_error);
+}
+
+// Per-frame fill of the instance buffer of the cubes demo, by SIMD level and
+// thread count, checked against the model matrices built one by one with
+// icg::rotation.
+void bench_instancing(int max_exponent)
+{
+    auto max_side = std::size_t{1};
+    for (int e = 0; e < std::min(max_exponent, 6); e += 2) {
+        max_side *= 10;
+    }
+    auto const max_threads = icg::resolve_num_threads(0);
+    // the fill has no AVX-512 kernel
+    auto const max_level = std::min(icg::detect_simd_level(), icg::simd_level::avx2);
+    constexpr auto seconds = 12.345f;
+    constexpr auto frames = 10;
+
+    for (std::size_t side = 32; side <= 2 * max_side; side *= 4) {
+        auto const motion = icg::instance_grid(side, seed);
+        auto transforms = std::vector<icg::mat4>(motion.size());
+
+        auto expected = std::vector<icg::mat4>(motion.size());
+        for (std::size_t i = 0; i < motion.size(); ++i) {
+            auto const reduced = [&](int d) {
+                auto const degrees = motion.rate[d][i] * seconds;
+                return degrees - 360.0f * std::floor(degrees / 360.0f);
+            };
+            auto const s = motion.scale;
+            auto const place = icg::mat4{{
+                s, 0, 0, 0,
+                0, s, 0, 0,
+                0, 0, -s, 0,
+                motion.offset[0][i], motion.offset[1][i], -motion.offset[2][i], 1
+            }};
+            expected[i] = place * icg::rotation(icg::vec3{reduced(0), reduced(1), reduced(2)});
+        }
+
+        // every thread count and level is checked, not only the fastest
+        auto max_error = 0.0f;
+        auto run = [&](unsigned threads, icg::simd_level level) {
+            auto const elapsed = time_seconds([&] {
+                for (int f = 0; f < frames; ++f) {
+                    icg::fill_instance_transforms(motion, seconds + static_cast<float>(f) / 60.0f, transforms, threads, level);
+                }
+            });
+            sink = transforms.back().m[0];
+
+            icg::fill_instance_transforms(motion, seconds, transforms, threads, level);
+            auto error = 0.0f;
+            for (std::size_t i = 0; i < motion.size(); ++i) {
+                for (int k = 0; k < 16; ++k) {
+                    error = std::max(error, std::abs(transforms[i].m[k] - expected[i].m[k]));
+                }
+            }
+            max_error = std::max(max_error, error);
+            auto const label = fmt::format("instances {} t={}{}", icg::name(level), threads, mismatch_unless(error <= 1e-6f));
+            report(label, frames * motion.size(), "instances", elapsed);
+        };
+        run(1, icg::simd_level::scalar);
+        if (max_level != icg::simd_level::scalar) {
+            run(1, max_level);
+        }
+        if (max_threads > 1) {
+            run(max_threads, max_level);
+        }
+        fmt::print("    {} instances, {} MiB per frame, max difference {:.2e}\n",
+            motion.size(), (sizeof(icg::mat4) * motion.size()) >> 20, max_error);
+    }
+}
+
+// Renders `frames` frames of `draw` into a 512x512 framebuffer in memory at
+// one and at all threads, checking that the images agree.
+template <typename Draw>
+void bench_frames(const std::string& name, int frames, Draw&& draw)
+{
+    auto const max_threads = icg::resolve_num_threads(0);
+    auto reference = std::uint64_t{};
+    for (auto threads : {1u, max_threads}) {
+        auto target = icg::soft::framebuffer{512, 512};
+        auto const seconds = time_seconds([&] {
+            for (int f = 0; f < frames; ++f) {
+                draw(target, icg::soft::state{true, threads}, f);
+            }
+        });
+        auto const hash = fingerprint(std::span<const icg::rgba8>{target.color});
+        if (threads == 1) {
+            reference = hash;
+        }
+        report(fmt::format("{} t={}{}", name, threads, mismatch_unless(hash == reference)), static_cast<std::size_t>(frames), "frames", seconds);
+        if (max_threads == 1) {
+            break;
+        }
+    }
+}
+
+// 02-gasket4, 04-cube and 02-gasket1 frames drawn by the software rasterizer
+// with the shaders of the demos written as lambdas.
+void bench_software_rasterizer(int max_exponent)
+{
+    constexpr auto white = icg::rgba8{255, 255, 255, 255};
+    constexpr auto frames = 20;
+
+    auto const& v = icg::gasket_regular_tetrahedron;
+    for (int count = 3; count <= std::min(max_exponent, 6); count += 3) {
+        auto const mesh = icg::divide_tetra_indexed(v[0], v[1], v[2], v[3], count);
+        auto const vs = [&](std::size_t i) {
+            auto const& p = mesh.positions[i];
+            auto const& c = mesh.colors[i];
+            return icg::soft::vertex_output{{p.x, p.y, p.z, 1.0f}, {c.x, c.y, c.z, 1.0f}};
+        };
+        bench_frames(fmt::format("soft gasket4 n={}", count), frames, [&](auto& target, const auto& state, int) {
+            target.clear(white);
+            std::visit([&](const auto& indices) {
+                icg::soft::draw_elements(target, state, icg::soft::primitive::triangles, std::span{indices}, vs);
+            }, mesh.indices);
+        });
+    }
+
+    constexpr auto corners = std::array{
+        icg::vec3{-0.5f, -0.5f,  0.5f}, icg::vec3{-0.5f,  0.5f,  0.5f},
+        icg::vec3{ 0.5f,  0.5f,  0.5f}, icg::vec3{ 0.5f, -0.5f,  0.5f},
+        icg::vec3{-0.5f, -0.5f, -0.5f}, icg::vec3{-0.5f,  0.5f, -0.5f},
+        icg::vec3{ 0.5f,  0.5f, -0.5f}, icg::vec3{ 0.5f, -0.5f, -0.5f}
+    };
+    constexpr auto corner_colors = std::array{
+        icg::vec4{0, 0, 0, 1}, icg::vec4{1, 0, 0, 1}, icg::vec4{1, 1, 0, 1}, icg::vec4{0, 1, 0, 1},
+        icg::vec4{0, 0, 1, 1}, icg::vec4{1, 0, 1, 1}, icg::vec4{0, 1, 1, 1}, icg::vec4{1, 1, 1, 1}
+    };
+    constexpr auto cube_indices = std::array<std::uint16_t, 36>{
+        1, 0, 3, 3, 2, 1, 2, 3, 7, 7, 6, 2, 3, 0, 4, 4, 7, 3,
+        6, 5, 1, 1, 2, 6, 4, 5, 6, 6, 7, 4, 5, 4, 0, 0, 1, 5
+    };
+    bench_frames("soft cube", 10 * frames, [&](auto& target, const auto& state, int frame) {
+        auto const model = icg::scale(icg::vec3{1.0f, 1.0f, -1.0f}) * icg::rotation(icg::vec3{2.0f * static_cast<float>(frame), 30.0f, 0.0f});
+        target.clear(white);
+        icg::soft::draw_elements(target, state, icg::soft::primitive::triangles, std::span{cube_indices}, [&](std::size_t i) {
+            auto const& p = corners[i];
+            return icg::soft::vertex_output{model * icg::vec4{p.x, p.y, p.z, 1.0f}, corner_colors[i]};
+        });
+    });
+
+    // a floor under a perspective camera that reaches behind the eye, so both
+    // of its triangles must be clipped against the near plane; it covers the
+    // bottom half of the frame up to the horizon
+    constexpr auto near = 0.1f;
+    constexpr auto far = 100.0f;
+    constexpr auto floor_corners = std::array{
+        icg::vec3{-50.0f, -1.0f, 5.0f}, icg::vec3{50.0f, -1.0f, 5.0f}, icg::vec3{50.0f, -1.0f, -50.0f}, icg::vec3{-50.0f, -1.0f, -50.0f}
+    };
+    auto floor = icg::soft::framebuffer{512, 512};
+    for (auto threads : {1u, icg::resolve_num_threads(0)}) {
+        floor.clear(white);
+        icg::soft::draw_arrays(floor, icg::soft::state{true, threads}, icg::soft::primitive::triangle_fan, 0, floor_corners.size(), [&](std::size_t i) {
+            auto const& p = floor_corners[i];
+            auto const z = (far + near) / (near - far) * p.z + 2.0f * far * near / (near - far);
+            return icg::soft::vertex_output{{p.x, p.y, z, -p.z}, {0.0f, 0.5f, 0.0f, 1.0f}};
+        });
+        auto covered = true;
+        for (int y = 0; y < 250; ++y) {
+            covered = covered && floor.pixel(0, y) != white && floor.pixel(511, y) != white;
+        }
+        if (!covered || floor.pixel(256, 260) != white) {
+            failed = true;
+            fmt::print("    MISMATCH: soft floor at t={} is not clipped at the near plane\n", threads);
+        }
+        if (icg::resolve_num_threads(0) == 1) {
+            break;
+        }
+    }
+
+    auto const points = icg::parallel_chaos_game(icg::gasket_triangle, std::min<std::size_t>(max_in_memory_size, 1'000'000), seed);
+    bench_frames(fmt::format("soft gasket1 p={}", points.size()), frames, [&](auto& target, const auto& state, int) {
+        target.clear(white);
+        icg::soft::draw_arrays(target, icg::soft::state{false, state.num_threads}, icg::soft::primitive::points, 0, points.size(), [&](std::size_t i) {
+            return icg::soft::vertex_output{{points[i].x, points[i].y, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f, 1.0f}};
+        });
+    });
+}
+
+// A CAD session of clicks as cad1 receives them, one press every frame at a
+// random position, written to an input log, read back and replayed frame by
+// frame into the rectangles cad1 would store. Replaying the log must give the
+// same rectangles as handling the clicks live.
+void bench_input_log(int max_exponent)
+{
+    auto clicks = std::size_t{1};
+    for (int e = 0; e < std::min(max_exponent, 6); ++e) {
+        clicks *= 10;
+    }
+    auto const path = std::filesystem::temp_directory_path() / "icg-bench-input.log";
+    auto const rng = icg::counter_rng::stream(seed, 0);
+
+    auto events = std::vector<icg::input_event>(clicks);
+    for (std::size_t i = 0; i < clicks; ++i) {
+        auto& e = events[i];
+        e.seconds = static_cast<double>(i) / 60.0;
+        e.frame = static_cast<std::uint32_t>(i);
+        e.x = static_cast<float>(icg::uniform_index(rng(2 * static_cast<std::uint32_t>(i)), 512));
+        e.y = static_cast<float>(icg::uniform_index(rng(2 * static_cast<std::uint32_t>(i) + 1), 512));
+        e.kind = icg::input_kind::mouse_button;
+    }
+
+    // Every second click completes a rectangle from the previous one.
+    auto const click = [](icg::growable_storage<icg::vec2>& rectangles, std::optional<icg::vec2>& corner, const icg::input_event& e) {
+        auto const p = icg::vec2{2 * e.x / 512 - 1, 2 * (512 - e.y) / 512 - 1};
+        if (!corner) {
+            corner = p;
+            return;
+        }
+        auto const q = *std::exchange(corner, std::nullopt);
+        rectangles.store(std::array{q, icg::vec2{q.x, p.y}, p, icg::vec2{p.x, q.y}});
+    };
+
+    auto live = icg::growable_storage<icg::vec2>{};
+    auto live_corner = std::optional<icg::vec2>{};
+    for (auto const& e : events) {
+        click(live, live_corner, e);
+    }
+
+    auto const record = time_seconds([&] {
+        auto writer = icg::input_log_writer{path};
+        for (auto const& e : events) {
+            writer.write(e);
+        }
+    });
+    report(fmt::format("input record e={}", clicks), clicks, "events", record);
+
+    auto replayed = icg::growable_storage<icg::vec2>{};
+    auto replayed_corner = std::optional<icg::vec2>{};
+    auto const replay = time_seconds([&] {
+        auto log = icg::input_replay{icg::read_input_log(path)};
+        while (!log.done()) {
+            for (auto const& e : log.next_frame()) {
+                click(replayed, replayed_corner, e);
+            }
+        }
+    });
+    report(fmt::format("input replay e={}", clicks), clicks, "events", replay);
+    if (fingerprint(replayed.data()) != fingerprint(live.data())) {
+        failed = true;
+        fmt::print("    MISMATCH: replayed session differs from the live one\n");
+    }
+    std::filesystem::remove(path);
+}
+
+// Program binaries of the size drivers produce stored in and loaded back from
+// a program_cache, as every demo does at startup. A corrupted entry must be
+// rejected rather than handed to the driver.
+void bench_program_cache()
+{
+    constexpr auto programs = std::size_t{100};
+    auto const directory = std::filesystem::temp_directory_path() / "icg-bench-programs";
+    std::filesystem::remove_all(directory);
+    auto cache = icg::program_cache{directory};
+
+    auto binary = icg::program_binary{0x8e21, std::vector<std::byte>(64 * 1024)};
+    auto const rng = icg::counter_rng::stream(seed, 1);
+    for (std::size_t i = 0; i < binary.data.size(); ++i) {
+        binary.data[i] = static_cast<std::byte>(rng(static_cast<std::uint32_t>(i)));
+    }
+    auto keys = std::vector<std::uint64_t>{};
+    for (std::size_t p = 0; p < programs; ++p) {
+        auto const source = fmt::format("#version 330 core\nvoid main() {{ gl_Position = vec4({}); }}\n", p);
+        auto const sources = std::array<std::string_view, 1>{source};
+        keys.push_back(icg::program_cache_key(sources, "vendor\nrenderer\nversion"));
+    }
+
+    auto const store = time_seconds([&] {
+        for (auto const key : keys) {
+            cache.store(key, binary);
+        }
+    });
+    report("program cache store", programs, "programs", store);
+
+    auto loaded = std::size_t{0};
+    auto const load = time_seconds([&] {
+        for (auto const key : keys) {
+            if (auto const b = cache.load(key); b && b->format == binary.format && b->data == binary.data) {
+                ++loaded;
+            }
+        }
+    });
+    report("program cache load", programs, "programs", load);
+
+    // flip a byte of the binary of the first entry
+    {
+        auto file = std::fstream{directory / fmt::format("{:016x}.bin", keys[0]), std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(-1, std::ios::end);
+        file.put('\xff' ^ static_cast<char>(binary.data.back()));
+    }
+    auto const corrupt_missed = !cache.load(keys[0]);
+    // an entry the driver refuses moves from the hits to the misses
+    if (cache.load(keys[1])) {
+        cache.reject();
+    }
+    auto const& stats = cache.stats();
+    if (loaded != programs || !corrupt_missed || stats.hits != programs || stats.misses != 2 || stats.rejected != 2) {
+        failed = true;
+        fmt::print("    MISMATCH: {} of {} binaries loaded back, {} hits, {} misses, {} rejected\n",
+            loaded, programs, stats.hits, stats.misses, stats.rejected);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+// A gasket3 point cloud stored in and mapped back from a geometry_cache,
+// against generating it again, as a warm start of a demo does. The mapped
+// points must equal the generated ones, and a corrupted entry must be
+// rejected.
+void bench_geometry_cache(int max_exponent)
+{
+    auto const size = std::min(static_cast<std::size_t>(std::pow(10.0, max_exponent)), max_in_memory_size);
+    auto const directory = std::filesystem::temp_directory_path() / "icg-bench-geometry";
+    std::filesystem::remove_all(directory);
+    auto cache = icg::geometry_cache{directory};
+
+    auto positions = std::vector<icg::vec3>{};
+    auto const generate = time_seconds([&] {
+        positions = icg::parallel_chaos_game(icg::gasket_tetrahedron, size, seed);
+    });
+    report(fmt::format("geometry generate e={}", max_exponent), size, "points", generate);
+
+    auto const key = icg::geometry_key{"parallel_chaos_game", icg::parallel_chaos_game_version, seed}.add(icg::gasket_tetrahedron).add(size);
+    auto const sections = std::array{icg::section_of(std::span<const icg::vec3>{positions}, "fff")};
+    auto stored = false;
+    auto const store = time_seconds([&] {
+        stored = cache.store(key, sections);
+    });
+    report(fmt::format("geometry store e={}", max_exponent), size, "points", store);
+
+    auto equal = false;
+    auto const load = time_seconds([&] {
+        if (auto const entry = cache.load(key)) {
+            auto const points = entry->elements<icg::vec3>(0);
+            equal = points.size() == positions.size()
+                && std::memcmp(points.data(), positions.data(), std::span{positions}.size_bytes()) == 0;
+        }
+    });
+    report(fmt::format("geometry load e={}", max_exponent), size, "points", load);
+
+    // a different seed is a different entry
+    auto const other = icg::geometry_key{"parallel_chaos_game", icg::parallel_chaos_game_version, seed + 1}.add(icg::gasket_tetrahedron).add(size);
+    auto const missed = !cache.load(other);
+
+    // flip a byte of the last point
+    {
+        auto file = std::fstream{cache.path(key), std::ios::binary | std::ios::in | std::ios::out};
+        file.seekg(-1, std::ios::end);
+        auto const byte = static_cast<char>(file.get());
+        file.seekp(-1, std::ios::end);
+        file.put(static_cast<char>(byte ^ 0x01));
+    }
+    if (!stored || !equal || !missed || cache.load(key) || cache.stats().rejected != 1 || cache.stats().hits != 1) {
+        failed = true;
+        fmt::print("    MISMATCH: stored {}, loaded back equal {}, {} hits, {} rejected\n",
+            stored, equal, cache.stats().hits, cache.stats().rejected);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+// Uniform updates of a scene of many programs, one per object, each setting
+// a model matrix and a color every frame while only every tenth object moves.
+// The shadow copies must let exactly the moving objects' matrices through.
+void bench_uniform_shadow(int max_exponent)
+{
+    constexpr auto programs = 1024;
+    constexpr auto model_loc = 0;
+    constexpr auto color_loc = 1;
+    auto const frames = std::size_t{1} << std::min(max_exponent, 10);
+
+    auto shadows = std::vector<icg::uniform_shadow>(programs);
+    for (auto& shadow : shadows) {
+        shadow.declare(model_loc, sizeof(icg::mat4));
+        shadow.declare(color_loc, sizeof(icg::vec4));
+    }
+    auto uploads = std::size_t{0};
+    auto const seconds = time_seconds([&] {
+        for (std::size_t f = 0; f < frames; ++f) {
+            for (int p = 0; p < programs; ++p) {
+                auto const angle = p % 10 == 0 ? static_cast<float>(f) : 0.0f;
+                auto const model = icg::rotation(icg::vec3{angle, 0.0f, static_cast<float>(p)});
+                uploads += shadows[p].update(model_loc, model);
+                uploads += shadows[p].update(color_loc, icg::vec4{1.0f, 0.0f, 0.0f, 1.0f});
+            }
+        }
+    });
+    auto const updates = frames * programs * 2;
+    report(fmt::format("uniform shadow f={}", frames), updates, "updates", seconds);
+
+    auto skipped = std::size_t{0};
+    for (auto const& shadow : shadows) {
+        skipped += shadow.stats().skipped;
+    }
+    fmt::print("    {} of {} uploads skipped\n", skipped, updates);
+    // both uniforms of every program in the first frame, then the matrices of
+    // the moving ones
+    auto const moving = static_cast<std::size_t>((programs + 9) / 10);
+    auto const expected = 2 * programs + (frames - 1) * moving;
+    if (uploads != expected || uploads + skipped != updates) {
+        failed = true;
+        fmt::print("    MISMATCH: {} uploads instead of {}\n", uploads, expected);
+    }
+}
+
+// Frames of the software-rendered cube handed to a frame_writer as an offscreen
+// batch render does, against rendering alone: with the frames encoded on
+// other threads the two should take about as long.
+void bench_frame_writer()
+{
+    constexpr auto frames = std::size_t{100};
+    auto const directory = std::filesystem::temp_directory_path() / "icg-bench-frames";
+    auto target = icg::soft::framebuffer{512, 512};
+    auto const draw = [&](std::size_t frame) {
+        auto const model = icg::rotation(icg::vec3{2.0f * static_cast<float>(frame), 30.0f, 0.0f});
+        target.clear(icg::rgba8{255, 255, 255, 255});
+        icg::soft::draw_arrays(target, icg::soft::state{}, icg::soft::primitive::triangle_fan, 0, 4, [&](std::size_t i) {
+            auto const corner = icg::vec4{i == 1 || i == 2 ? 0.5f : -0.5f, i >= 2 ? 0.5f : -0.5f, 0.0f, 1.0f};
+            return icg::soft::vertex_output{model * corner, icg::vec4{1.0f, 0.0f, 0.0f, 1.0f}};
+        });
+    };
+
+    auto const render = time_seconds([&] {
+        for (std::size_t f = 0; f < frames; ++f) {
+            draw(f);
+        }
+    });
+    report("render 512x512", frames, "frames", render);
+
+    auto const write = time_seconds([&] {
+        auto writer = icg::frame_writer{directory, "bench"};
+        for (std::size_t f = 0; f < frames; ++f) {
+            draw(f);
+            writer.submit(f, icg::image{target.width, target.height, target.color});
+        }
+        writer.finish();
+    });
+    report("render and write ppm", frames, "frames", write);
+    std::filesystem::remove_all(directory);
+}
+
+// Frames of the software-rendered gasket timed by the profiler the demos use,
+// with its percentiles and the cost of recording itself.
+void bench_profiler()
+{
+    constexpr auto frames = 200;
+    auto const& v = icg::gasket_regular_tetrahedron;
+    auto const mesh = icg::divide_tetra_indexed(v[0], v[1], v[2], v[3], 4);
+    auto target = icg::soft::framebuffer{512, 512};
+    auto frame_profiler = icg::profiler{};
+    for (int f = 0; f < frames; ++f) {
+        auto const phase = icg::scoped_phase{frame_profiler, icg::frame_phase::draw};
+        target.clear(icg::rgba8{255, 255, 255, 255});
+        std::visit([&](const auto& indices) {
+            icg::soft::draw_elements(target, icg::soft::state{true, 0}, icg::soft::primitive::triangles, std::span{indices}, [&](std::size_t i) {
+                auto const& p = mesh.positions[i];
+                auto const& c = mesh.colors[i];
+                return icg::soft::vertex_output{{p.x, p.y, p.z, 1.0f}, {c.x, c.y, c.z, 1.0f}};
+            });
+        }, mesh.indices);
+    }
+    auto times = std::vector<float>{};
+    for (auto const& sample : frame_profiler.latest(frames)) {
+        times.push_back(sample.cpu_ms());
+    }
+    auto const p = icg::compute_percentiles(times);
+    fmt::print("{:<24} p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms over {} frames\n", "profiler soft gasket4", p.p50, p.p95, p.p99, times.size());
+
+    constexpr auto records = std::size_t{1'000'000};
+    auto overhead = icg::profiler{};
+    auto const seconds = time_seconds([&] {
+        for (std::size_t i = 0; i < records; ++i) {
+            auto const phase = icg::scoped_phase{overhead, icg::frame_phase::draw};
+        }
+    });
+    report("profiler record", records, "phases", seconds);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // Sizes go from 10^3 up to 10^max_exponent elements.
+    auto const max_exponent = argc > 1 ? std::atoi(argv[1]) : 7;
+    if (max_exponent < 3 || max_exponent > 9) {
+        fmt::print(stderr, "usage: {} [max_exponent in 3..9]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bench_counter_rng_streams();
+    bench_chaos_game(max_exponent);
+    bench_progressive_chaos_game(max_exponent);
+    bench_chaos_game_chains(max_exponent);
+    bench_ifs(max_exponent);
+    bench_density(max_exponent);
+    bench_subdivision(max_exponent);
+    bench_dirty_ranges(max_exponent);
+    bench_growable_storage(max_exponent);
+    bench_draw_batch(max_exponent);
+    bench_transform(max_exponent);
+    bench_instancing(max_exponent);
+    bench_uniform_shadow(max_exponent);
+    bench_software_rasterizer(max_exponent);
+    bench_input_log(max_exponent);
+    bench_frame_writer();
+    bench_program_cache();
+    bench_geometry_cache(max_exponent);
+    bench_profiler();
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
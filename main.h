@@ -1,20 +1,48 @@
 #ifndef MAIN_H
 #define MAIN_H
 
-#define MAIN                                     \
-int main()                                       \
-{                                                \
-    try {                                        \
-        tinygl::init(3, 3);                      \
-        window w(512, 512, NAME, true);          \
-        w.run();                                 \
-    } catch (const std::exception& e) {          \
-        tinygl::terminate();                     \
-        std::cerr << e.what() << std::endl;      \
-        return EXIT_FAILURE;                     \
-    }                                            \
-                                                 \
-    return EXIT_SUCCESS;                         \
-}                                                \
+#include <icg/frame_clock.h>
+#include <icg/gl/input_window.h>
+#include <icg/gl/offscreen.h>
+#include <icg/gl/profiled_window.h>
+#include <icg/render_options.h>
+#include <icg/shader_source.h>
+#include <GLFW/glfw3.h>
+
+// Runs the demo in a window, or with --frames renders frames offscreen in a
+// hidden window and writes them to disk (see icg::render_options). Either way
+// its frames are timed by icg::gl::profiled_window. The last argument of the
+// window turns vsync on or off. Demos deriving from icg::gl::input_window have their input
+// recorded or replayed as the options say.
+#define MAIN                                                                     \
+int main(int argc, char* argv[])                                                 \
+{                                                                                \
+    try {                                                                        \
+        auto const options = icg::parse_render_options(argc, argv);              \
+        icg::set_default_fixed_step(options.fixed_step);                         \
+        icg::set_default_input_session(                                          \
+            {options.record, options.replay, options.replay_fast});              \
+        icg::set_default_shader_directory(options.shader_directory);             \
+        tinygl::init(3, 3);                                                      \
+        if (options.offscreen()) {                                               \
+            /* frames only go to disk, so the window is never shown */           \
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);                            \
+            icg::gl::profiled_window<icg::gl::input_driven<window>> w(           \
+                options.profile, options.width, options.height,                  \
+                NAME, options.vsync);                                            \
+            icg::gl::render_offscreen(w, options, NAME);                         \
+        } else {                                                                 \
+            icg::gl::profiled_window<icg::gl::input_driven<window>> w(           \
+                options.profile, 512, 512, NAME, options.vsync);                 \
+            w.run();                                                             \
+        }                                                                        \
+    } catch (const std::exception& e) {                                          \
+        tinygl::terminate();                                                     \
+        std::cerr << e.what() << std::endl;                                      \
+        return EXIT_FAILURE;                                                     \
+    }                                                                            \
+                                                                                 \
+    return EXIT_SUCCESS;                                                         \
+}                                                                                \
 
 #endif // MAIN_H
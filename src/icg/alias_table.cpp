@@ -0,0 +1,67 @@
+#include "alias_table.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace icg {
+
+namespace {
+
+constexpr std::int64_t one = std::int64_t{1} << 16;
+
+} // namespace
+
+alias_table make_alias_table(std::span<const float> weights)
+{
+    if (weights.empty() || weights.size() > static_cast<std::size_t>(one)) {
+        throw std::invalid_argument{"An alias table takes 1 to 65536 weights"};
+    }
+    auto sum = 0.0;
+    for (auto const w : weights) {
+        if (!(w >= 0.0f) || std::isinf(w)) {
+            throw std::invalid_argument{"Alias table weights must be finite and non-negative"};
+        }
+        sum += w;
+    }
+    if (sum == 0.0) {
+        throw std::invalid_argument{"Alias table weights must not all be zero"};
+    }
+
+    // Quantize to integers that sum to exactly one per column, so that the
+    // construction below is exact.
+    auto const n = static_cast<std::int64_t>(weights.size());
+    auto scaled = std::vector<std::int64_t>(weights.size());
+    auto total = std::int64_t{0};
+    for (std::size_t j = 0; j < weights.size(); ++j) {
+        scaled[j] = std::llround(weights[j] / sum * static_cast<double>(n * one));
+        total += scaled[j];
+    }
+    *std::ranges::max_element(scaled) += n * one - total;
+
+    // Vose's construction: every column below one is topped up from a column
+    // above it, which becomes its alias.
+    auto table = alias_table{
+        std::vector<std::uint32_t>(weights.size(), static_cast<std::uint32_t>(one)),
+        std::vector<std::uint32_t>(weights.size())};
+    auto small = std::vector<std::uint32_t>{};
+    auto large = std::vector<std::uint32_t>{};
+    for (std::uint32_t j = 0; j < weights.size(); ++j) {
+        table.alias[j] = j;
+        (scaled[j] < one ? small : large).push_back(j);
+    }
+    while (!small.empty() && !large.empty()) {
+        auto const s = small.back();
+        auto const l = large.back();
+        small.pop_back();
+        table.threshold[s] = static_cast<std::uint32_t>(scaled[s]);
+        table.alias[s] = l;
+        scaled[l] -= one - scaled[s];
+        if (scaled[l] < one) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    return table;
+}
+
+} // namespace icg
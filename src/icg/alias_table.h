@@ -0,0 +1,40 @@
+#ifndef ICG_ALIAS_TABLE_H
+#define ICG_ALIAS_TABLE_H
+
+#include "random.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace icg {
+
+// Walker's alias method: picks index j with probability proportional to
+// weights[j] in constant time from a single 32-bit random number. Its upper
+// 16 bits select a column uniformly, as uniform_index does, and its lower 16
+// bits keep the column if they are below its threshold, or take its alias
+// otherwise. The probabilities are quantized to multiples of 2^-16 / size().
+struct alias_table
+{
+    // In [0, 2^16]; 2^16 always keeps the column.
+    std::vector<std::uint32_t> threshold;
+    std::vector<std::uint32_t> alias;
+
+    std::size_t size() const { return threshold.size(); }
+};
+
+// Builds the table of 1 to 2^16 non-negative weights, not all zero, which
+// need not sum to 1. Throws std::invalid_argument otherwise.
+alias_table make_alias_table(std::span<const float> weights);
+
+// Branch-free pick from a table of `n` columns, given as arrays so that the
+// SIMD kernels can look both up from registers.
+constexpr std::uint32_t sample_alias(const std::uint32_t* threshold, const std::uint32_t* alias, std::uint32_t n, std::uint32_t random)
+{
+    auto const column = uniform_index(random, n);
+    return (random & 0xffffu) < threshold[column] ? column : alias[column];
+}
+
+} // namespace icg
+
+#endif // ICG_ALIAS_TABLE_H
@@ -0,0 +1,186 @@
+#include "chaos_game.h"
+#include "chaos_game_kernels.h"
+#include "density.h"
+#include <algorithm>
+#include <random>
+
+namespace icg {
+
+namespace {
+
+using detail::aos_store;
+using detail::component;
+using detail::dimension;
+using detail::soa_store;
+
+template <typename Vec, std::size_t N>
+std::vector<Vec> chaos_game(const std::array<Vec, N>& vertices, Vec start, std::size_t num_positions, std::uint32_t seed)
+{
+    auto positions = std::vector<Vec>{};
+    if (num_positions == 0) {
+        return positions;
+    }
+    positions.reserve(num_positions);
+    positions.push_back(start);
+
+    auto engine = std::mt19937{seed};
+    auto distribution = std::uniform_int_distribution<int>{0, static_cast<int>(N) - 1};
+
+    for (std::size_t i = 1; i < num_positions; ++i) {
+        auto const j = distribution(engine);
+        positions.push_back(0.5f * (positions[i - 1] + vertices[j]));
+    }
+
+    return positions;
+}
+
+template <typename Vec, std::size_t N>
+Vec centroid(const std::array<Vec, N>& vertices)
+{
+    auto sum = vertices[0];
+    for (std::size_t j = 1; j < N; ++j) {
+        sum = sum + vertices[j];
+    }
+    return (1.0f / N) * sum;
+}
+
+// The step of the chains with the widest kernel up to `level` that the CPU
+// supports.
+template <typename Vec, std::size_t N>
+auto chaos_game_advance(const std::array<Vec, N>& vertices, simd_level level)
+{
+    constexpr auto D = dimension<Vec>;
+    static_assert(N <= 8, "the AVX2 kernel picks vertices from a single register");
+
+    auto table = detail::chaos_game_vertices{};
+    for (std::size_t j = 0; j < N; ++j) {
+        for (int d = 0; d < D; ++d) {
+            table.components[d][j] = component(vertices[j], d);
+        }
+    }
+    table.count = N;
+
+    auto const kernel = detail::select_chaos_game_kernel(D, supported_simd_level(level));
+    return [table, kernel](const std::uint32_t* keys, std::uint32_t counter, std::size_t steps, float* state, float* tile) {
+        kernel(table, keys, counter, steps, state, tile);
+    };
+}
+
+template <typename Vec, std::size_t N, typename Store>
+void parallel_chaos_game(
+    const std::array<Vec, N>& vertices,
+    std::size_t first_chain,
+    std::size_t num_positions,
+    std::uint32_t seed,
+    unsigned num_threads,
+    simd_level level,
+    Store&& store)
+{
+    detail::parallel_chains(centroid(vertices), first_chain, num_positions, seed, num_threads, chaos_game_advance(vertices, level), store);
+}
+
+} // namespace
+
+std::vector<vec2> chaos_game(const std::array<vec2, 3>& vertices, vec2 start, std::size_t num_positions, std::uint32_t seed)
+{
+    return chaos_game<vec2, 3>(vertices, start, num_positions, seed);
+}
+
+std::vector<vec3> chaos_game(const std::array<vec3, 4>& vertices, vec3 start, std::size_t num_positions, std::uint32_t seed)
+{
+    return chaos_game<vec3, 4>(vertices, start, num_positions, seed);
+}
+
+void parallel_chaos_game(const std::array<vec2, 3>& vertices, std::span<vec2> positions, std::uint32_t seed, unsigned num_threads, simd_level level)
+{
+    parallel_chaos_game(vertices, 0, positions.size(), seed, num_threads, level, aos_store(positions));
+}
+
+void parallel_chaos_game(const std::array<vec3, 4>& vertices, std::span<vec3> positions, std::uint32_t seed, unsigned num_threads, simd_level level)
+{
+    parallel_chaos_game(vertices, 0, positions.size(), seed, num_threads, level, aos_store(positions));
+}
+
+std::vector<vec2> parallel_chaos_game(const std::array<vec2, 3>& vertices, std::size_t num_positions, std::uint32_t seed, unsigned num_threads, simd_level level)
+{
+    auto positions = std::vector<vec2>(num_positions);
+    parallel_chaos_game(vertices, std::span{positions}, seed, num_threads, level);
+    return positions;
+}
+
+std::vector<vec3> parallel_chaos_game(const std::array<vec3, 4>& vertices, std::size_t num_positions, std::uint32_t seed, unsigned num_threads, simd_level level)
+{
+    auto positions = std::vector<vec3>(num_positions);
+    parallel_chaos_game(vertices, std::span{positions}, seed, num_threads, level);
+    return positions;
+}
+
+void parallel_chaos_game(const std::array<vec2, 3>& vertices, soa_points& points, std::uint32_t seed, unsigned num_threads, simd_level level)
+{
+    parallel_chaos_game(vertices, 0, points.size(), seed, num_threads, level, soa_store<2>(points));
+}
+
+void parallel_chaos_game(const std::array<vec3, 4>& vertices, soa_points& points, std::uint32_t seed, unsigned num_threads, simd_level level)
+{
+    parallel_chaos_game(vertices, 0, points.size(), seed, num_threads, level, soa_store<3>(points));
+}
+
+template <typename Vec, std::size_t N>
+chaos_game_stream<Vec, N>::chaos_game_stream(
+    const std::array<Vec, N>& vertices,
+    std::size_t num_positions,
+    std::uint32_t seed,
+    std::size_t chunk_size,
+    unsigned num_threads,
+    simd_level level)
+    : vertices{vertices}
+    , num_positions{num_positions}
+    , chunk_size{std::max<std::size_t>(1, (chunk_size + chaos_game_chain_length - 1) / chaos_game_chain_length) * chaos_game_chain_length}
+    , seed{seed}
+    , num_threads{num_threads}
+    , level{level}
+{
+}
+
+template <typename Vec, std::size_t N>
+std::size_t chaos_game_stream<Vec, N>::next_chunk_size() const
+{
+    return std::min(chunk_size, num_positions - next);
+}
+
+template <typename Vec, std::size_t N>
+void chaos_game_stream<Vec, N>::generate(std::span<Vec> chunk)
+{
+    chunk = chunk.first(next_chunk_size());
+    parallel_chaos_game(vertices, next / chaos_game_chain_length, chunk.size(), seed, num_threads, level, aos_store(chunk));
+    next += chunk.size();
+}
+
+template class chaos_game_stream<vec2, 3>;
+template class chaos_game_stream<vec3, 4>;
+
+density chaos_game_density(const std::array<vec2, 3>& vertices, std::size_t num_positions, std::uint32_t seed, const density_grid& grid, unsigned num_threads, simd_level level)
+{
+    return detail::density_chains(centroid(vertices), num_positions, seed, num_threads, chaos_game_advance(vertices, level), grid);
+}
+
+density chaos_game_density(const std::array<vec3, 4>& vertices, std::size_t num_positions, std::uint32_t seed, const density_grid& grid, unsigned num_threads, simd_level level)
+{
+    return detail::density_chains(centroid(vertices), num_positions, seed, num_threads, chaos_game_advance(vertices, level), grid);
+}
+
+void interleave(const soa_points& points, std::span<vec2> positions)
+{
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        positions[i] = vec2{points.x[i], points.y[i]};
+    }
+}
+
+void interleave(const soa_points& points, std::span<vec3> positions)
+{
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        positions[i] = vec3{points.x[i], points.y[i], points.z[i]};
+    }
+}
+
+} // namespace icg
@@ -0,0 +1,114 @@
+#ifndef ICG_CHAOS_GAME_H
+#define ICG_CHAOS_GAME_H
+
+#include "random.h"
+#include "shapes.h"
+#include "simd.h"
+#include "vector.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace icg {
+
+// Chaos game: starting from `start`, each new point is located midway between
+// the last point and a randomly chosen vertex. The result holds `num_positions`
+// points, the first of which is `start`.
+std::vector<vec2> chaos_game(const std::array<vec2, 3>& vertices, vec2 start, std::size_t num_positions, std::uint32_t seed);
+std::vector<vec3> chaos_game(const std::array<vec3, 4>& vertices, vec3 start, std::size_t num_positions, std::uint32_t seed);
+
+// The parallel chaos game splits its output into independent chains of
+// chaos_game_chain_length points. Chain c starts at the centroid of the
+// vertices, picks vertices from stream c of a counter_rng seeded with `seed`
+// and discards its first chaos_game_burn_in points, after which it lies on the
+// gasket to within float precision.
+constexpr std::size_t chaos_game_chain_length = std::size_t{1} << 16;
+constexpr std::uint32_t chaos_game_burn_in = 32;
+
+// A chain draws its numbers from a stretch of the Weyl sequence of its own.
+static_assert(chaos_game_chain_length + chaos_game_burn_in <= counter_rng::stream_spacing);
+
+// Structure-of-arrays point cloud: point i is (x[i], y[i]) in 2D and
+// (x[i], y[i], z[i]) in 3D, where z stays empty.
+struct soa_points
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+
+    std::size_t size() const { return x.size(); }
+};
+
+// Version of the output of parallel_chaos_game for a geometry_key, bumped
+// whenever it changes for the same seed.
+constexpr std::uint32_t parallel_chaos_game_version = 1;
+
+// Fills `positions` with the parallel chaos game on up to `num_threads` threads
+// (0 uses all cores), advancing 16 chains at once with the widest kernel up to
+// `level` that the CPU supports. The result only depends on the seed, so it is
+// byte for byte identical at any thread count and SIMD level.
+void parallel_chaos_game(const std::array<vec2, 3>& vertices, std::span<vec2> positions, std::uint32_t seed, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+void parallel_chaos_game(const std::array<vec3, 4>& vertices, std::span<vec3> positions, std::uint32_t seed, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+
+std::vector<vec2> parallel_chaos_game(const std::array<vec2, 3>& vertices, std::size_t num_positions, std::uint32_t seed, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+std::vector<vec3> parallel_chaos_game(const std::array<vec3, 4>& vertices, std::size_t num_positions, std::uint32_t seed, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+
+// Same as above, but keeps the points as structure of arrays, whose components
+// must already be sized to the number of points to generate.
+void parallel_chaos_game(const std::array<vec2, 3>& vertices, soa_points& points, std::uint32_t seed, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+void parallel_chaos_game(const std::array<vec3, 4>& vertices, soa_points& points, std::uint32_t seed, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+
+// Points per chunk of chaos_game_stream by default: 256 chains, which is
+// enough to keep 16 threads busy.
+constexpr std::size_t chaos_game_chunk_size = 256 * chaos_game_chain_length;
+
+// Generates the parallel chaos game in consecutive chunks, each written
+// straight into storage supplied by the caller, e.g. a mapped range of a
+// vertex buffer, so no intermediate copy of the point cloud is ever allocated.
+// Concatenated, the chunks are identical to the output of parallel_chaos_game.
+template <typename Vec, std::size_t N>
+class chaos_game_stream
+{
+public:
+    // The chunk size is rounded up to a multiple of chaos_game_chain_length.
+    chaos_game_stream(
+        const std::array<Vec, N>& vertices,
+        std::size_t num_positions,
+        std::uint32_t seed,
+        std::size_t chunk_size = chaos_game_chunk_size,
+        unsigned num_threads = 0,
+        simd_level level = simd_level::avx512);
+
+    std::size_t size() const { return num_positions; }
+
+    // Index of the first point of the next chunk.
+    std::size_t position() const { return next; }
+
+    // Number of points in the next chunk, 0 once all of them are generated.
+    std::size_t next_chunk_size() const;
+
+    // Writes the next chunk into the first next_chunk_size() points of `chunk`.
+    void generate(std::span<Vec> chunk);
+
+private:
+    std::array<Vec, N> vertices;
+    std::size_t num_positions;
+    std::size_t chunk_size;
+    std::uint32_t seed;
+    unsigned num_threads;
+    simd_level level;
+    std::size_t next{0};
+};
+
+extern template class chaos_game_stream<vec2, 3>;
+extern template class chaos_game_stream<vec3, 4>;
+
+// Converts structure-of-arrays points into the interleaved vertex layout.
+void interleave(const soa_points& points, std::span<vec2> positions);
+void interleave(const soa_points& points, std::span<vec3> positions);
+
+} // namespace icg
+
+#endif // ICG_CHAOS_GAME_H
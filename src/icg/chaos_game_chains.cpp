@@ -0,0 +1,57 @@
+#include "chaos_game_chains.h"
+#include "parallel.h"
+#include "random.h"
+#include <algorithm>
+
+namespace icg {
+
+namespace {
+
+// Chains per work item of the parallel reference.
+constexpr std::size_t chains_per_task = 256;
+
+} // namespace
+
+std::vector<std::uint32_t> chaos_game_chain_keys(std::uint32_t seed, std::size_t num_chains)
+{
+    auto keys = std::vector<std::uint32_t>(num_chains);
+    for (std::size_t c = 0; c < num_chains; ++c) {
+        keys[c] = counter_rng::stream(seed, c).key;
+    }
+    return keys;
+}
+
+vec3 chaos_game_chain_start(const std::array<vec3, 4>& vertices)
+{
+    // as parallel_chaos_game computes it
+    auto sum = vertices[0];
+    for (std::size_t j = 1; j < vertices.size(); ++j) {
+        sum = sum + vertices[j];
+    }
+    return (1.0f / vertices.size()) * sum;
+}
+
+std::vector<vec3> chaos_game_chains(const std::array<vec3, 4>& vertices, std::size_t num_chains, std::size_t steps, std::uint32_t seed, unsigned num_threads)
+{
+    auto positions = std::vector<vec3>(num_chains * steps);
+    auto const keys = chaos_game_chain_keys(seed, num_chains);
+    auto const start = chaos_game_chain_start(vertices);
+    auto const count = static_cast<std::uint32_t>(vertices.size());
+
+    parallel_for((num_chains + chains_per_task - 1) / chains_per_task, num_threads, [&](std::size_t task) {
+        auto const last = std::min(num_chains, (task + 1) * chains_per_task);
+        for (auto c = task * chains_per_task; c < last; ++c) {
+            auto const rng = counter_rng{keys[c]};
+            auto p = start;
+            for (std::uint32_t t = 0; t < chaos_game_burn_in + steps; ++t) {
+                p = 0.5f * (p + vertices[uniform_index(rng(t), count)]);
+                if (t >= chaos_game_burn_in) {
+                    positions[(t - chaos_game_burn_in) * num_chains + c] = p;
+                }
+            }
+        }
+    });
+    return positions;
+}
+
+} // namespace icg
@@ -0,0 +1,34 @@
+#ifndef ICG_CHAOS_GAME_CHAINS_H
+#define ICG_CHAOS_GAME_CHAINS_H
+
+#include "chaos_game.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace icg {
+
+// The chains of the parallel chaos game advanced one step at a time across all
+// of them, as the transform feedback engine (icg::gl::transform_feedback_chaos_game)
+// runs them on the GPU: point k of chain c is element k * num_chains + c, and
+// equals point k of chain c of parallel_chaos_game with the same seed.
+//
+// This is the CPU reference of that engine: the same counter_rng streams, the
+// same start at the centroid and the same float operations, one rounding each,
+// so its output is bit for bit what a conforming GPU computes.
+
+// Key of the counter_rng stream of each chain, which the GPU cannot derive
+// itself without 64-bit integers.
+std::vector<std::uint32_t> chaos_game_chain_keys(std::uint32_t seed, std::size_t num_chains);
+
+// Where every chain starts: the centroid of the vertices.
+vec3 chaos_game_chain_start(const std::array<vec3, 4>& vertices);
+
+// `steps` points of each of `num_chains` chains, step-major, on up to
+// `num_threads` threads (0 uses all cores).
+std::vector<vec3> chaos_game_chains(const std::array<vec3, 4>& vertices, std::size_t num_chains, std::size_t steps, std::uint32_t seed, unsigned num_threads = 0);
+
+} // namespace icg
+
+#endif // ICG_CHAOS_GAME_CHAINS_H
@@ -0,0 +1,163 @@
+#include "chaos_game_kernels.h"
+#include "random.h"
+#include "random_kernels.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ICG_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace icg::detail {
+
+namespace {
+
+constexpr auto lanes = chaos_game_lanes;
+constexpr auto tile_steps = chaos_game_tile_steps;
+
+template <int D>
+void chaos_game_kernel_scalar(
+    const chaos_game_vertices& vertices,
+    const std::uint32_t* keys,
+    std::uint32_t counter,
+    std::size_t steps,
+    float* state,
+    float* tile)
+{
+    for (std::size_t l = 0; l < lanes; ++l) {
+        auto const rng = counter_rng{keys[l]};
+        for (std::size_t t = 0; t < steps; ++t) {
+            auto const j = uniform_index(rng(counter + static_cast<std::uint32_t>(t)), vertices.count);
+            for (int d = 0; d < D; ++d) {
+                auto& p = state[d * lanes + l];
+                p = 0.5f * (p + vertices.components[d][j]);
+                tile[(d * tile_steps + t) * lanes + l] = p;
+            }
+        }
+    }
+}
+
+#ifdef ICG_X86_KERNELS
+
+// The kernels below replicate counter_rng and uniform_index lane by lane.
+
+template <int D>
+__attribute__((target("avx2")))
+void chaos_game_kernel_avx2(
+    const chaos_game_vertices& vertices,
+    const std::uint32_t* keys,
+    std::uint32_t counter,
+    std::size_t steps,
+    float* state,
+    float* tile)
+{
+    constexpr int halves = lanes / 8;
+
+    __m256 table[D];
+    __m256 p[D][halves];
+    for (int d = 0; d < D; ++d) {
+        table[d] = _mm256_load_ps(vertices.components[d]);
+        for (int h = 0; h < halves; ++h) {
+            p[d][h] = _mm256_loadu_ps(state + d * lanes + 8 * h);
+        }
+    }
+
+    __m256i key[halves];
+    for (int h = 0; h < halves; ++h) {
+        key[h] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + 8 * h));
+    }
+
+    auto const count = _mm256_set1_epi32(static_cast<int>(vertices.count));
+    auto const half = _mm256_set1_ps(0.5f);
+
+    for (std::size_t t = 0; t < steps; ++t) {
+        auto const weyl = _mm256_set1_epi32(static_cast<int>((counter + static_cast<std::uint32_t>(t)) * 0x9e3779b9u));
+        for (int h = 0; h < halves; ++h) {
+            auto const x = counter_rng_avx2(weyl, key[h]);
+            auto const j = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(x, 16), count), 16);
+            for (int d = 0; d < D; ++d) {
+                auto const v = _mm256_permutevar8x32_ps(table[d], j);
+                p[d][h] = _mm256_mul_ps(half, _mm256_add_ps(p[d][h], v));
+                _mm256_storeu_ps(tile + (d * tile_steps + t) * lanes + 8 * h, p[d][h]);
+            }
+        }
+    }
+
+    for (int d = 0; d < D; ++d) {
+        for (int h = 0; h < halves; ++h) {
+            _mm256_storeu_ps(state + d * lanes + 8 * h, p[d][h]);
+        }
+    }
+}
+
+// GCC 12 reports the deliberately undefined pass-through operands inside its
+// own AVX-512 intrinsics as maybe uninitialized.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+template <int D>
+__attribute__((target("avx512f")))
+void chaos_game_kernel_avx512(
+    const chaos_game_vertices& vertices,
+    const std::uint32_t* keys,
+    std::uint32_t counter,
+    std::size_t steps,
+    float* state,
+    float* tile)
+{
+    static_assert(lanes == 16);
+
+    __m512 table[D];
+    __m512 p[D];
+    for (int d = 0; d < D; ++d) {
+        table[d] = _mm512_load_ps(vertices.components[d]);
+        p[d] = _mm512_loadu_ps(state + d * lanes);
+    }
+
+    auto const key = _mm512_loadu_si512(keys);
+    auto const count = _mm512_set1_epi32(static_cast<int>(vertices.count));
+    auto const half = _mm512_set1_ps(0.5f);
+
+    for (std::size_t t = 0; t < steps; ++t) {
+        auto const weyl = _mm512_set1_epi32(static_cast<int>((counter + static_cast<std::uint32_t>(t)) * 0x9e3779b9u));
+        auto const x = counter_rng_avx512(weyl, key);
+        auto const j = _mm512_srli_epi32(_mm512_mullo_epi32(_mm512_srli_epi32(x, 16), count), 16);
+        for (int d = 0; d < D; ++d) {
+            auto const v = _mm512_permutexvar_ps(j, table[d]);
+            p[d] = _mm512_mul_ps(half, _mm512_add_ps(p[d], v));
+            _mm512_storeu_ps(tile + (d * tile_steps + t) * lanes, p[d]);
+        }
+    }
+
+    for (int d = 0; d < D; ++d) {
+        _mm512_storeu_ps(state + d * lanes, p[d]);
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // ICG_X86_KERNELS
+
+} // namespace
+
+chaos_game_kernel select_chaos_game_kernel(int dimension, simd_level level)
+{
+#ifdef ICG_X86_KERNELS
+    switch (level) {
+        case simd_level::avx512:
+            return dimension == 2 ? chaos_game_kernel_avx512<2> : chaos_game_kernel_avx512<3>;
+        case simd_level::avx2:
+            return dimension == 2 ? chaos_game_kernel_avx2<2> : chaos_game_kernel_avx2<3>;
+        case simd_level::scalar:
+            break;
+    }
+#else
+    static_cast<void>(level);
+#endif
+    return dimension == 2 ? chaos_game_kernel_scalar<2> : chaos_game_kernel_scalar<3>;
+}
+
+} // namespace icg::detail
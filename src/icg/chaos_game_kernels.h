@@ -0,0 +1,235 @@
+#ifndef ICG_CHAOS_GAME_KERNELS_H
+#define ICG_CHAOS_GAME_KERNELS_H
+
+#include "chaos_game.h"
+#include "density.h"
+#include "parallel.h"
+#include "random.h"
+#include "simd.h"
+#include "vector.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace icg::detail {
+
+// The chaos game kernels advance chaos_game_lanes chains in lockstep. Their
+// state and output are kept as structure of arrays: component d of lane l is
+// state[d * chaos_game_lanes + l], and of step t of lane l in the output tile
+// tile[(d * chaos_game_tile_steps + t) * chaos_game_lanes + l].
+constexpr std::size_t chaos_game_lanes = 16;
+constexpr std::size_t chaos_game_tile_steps = 64;
+
+// Attractor vertices, component by component, padded to a full register.
+struct chaos_game_vertices
+{
+    alignas(64) float components[3][chaos_game_lanes];
+    std::uint32_t count;
+};
+
+// Advances every lane by `steps` <= chaos_game_tile_steps points, drawing the
+// vertex of step t from the counter_rng of the lane at counter + t.
+using chaos_game_kernel = void (*)(
+    const chaos_game_vertices& vertices,
+    const std::uint32_t* keys,
+    std::uint32_t counter,
+    std::size_t steps,
+    float* state,
+    float* tile);
+
+// The kernel for `dimension` (2 or 3) components at the given level, which
+// must be supported by the CPU. All kernels produce bit-identical results.
+chaos_game_kernel select_chaos_game_kernel(int dimension, simd_level level);
+
+// The driver below is shared by every generator built from chains of
+// chaos_game_chain_length points, whatever their kernel.
+
+template <typename Vec>
+constexpr int dimension = sizeof(Vec) / sizeof(float);
+
+constexpr float component(const vec2& v, int d) { return d == 0 ? v.x : v.y; }
+constexpr float component(const vec3& v, int d) { return d == 0 ? v.x : d == 1 ? v.y : v.z; }
+
+// Runs chains [group * chaos_game_lanes, (group + 1) * chaos_game_lanes) of
+// `num_positions` points, counted from chain `first_chain`. Every chain starts
+// at `start`, draws from stream first_chain + chain of a counter_rng seeded
+// with `seed` and discards its first chaos_game_burn_in points. The lanes are
+// advanced by advance(keys, counter, steps, state, tile), with the arguments
+// of a chaos_game_kernel, and every tile of output is handed to
+// store(chain, first, steps, tile, lane), where `first` is the index within
+// the chain of the first of the `steps` points of lane `lane`.
+template <typename Vec, typename Advance, typename Store>
+void chaos_game_group(
+    Vec start,
+    std::size_t first_chain,
+    std::size_t num_positions,
+    std::size_t group,
+    std::uint32_t seed,
+    Advance&& advance,
+    Store&& store)
+{
+    constexpr auto D = dimension<Vec>;
+
+    float state[D * chaos_game_lanes];
+    std::uint32_t keys[chaos_game_lanes];
+    std::size_t lengths[chaos_game_lanes];
+    auto max_length = std::size_t{0};
+    for (std::size_t l = 0; l < chaos_game_lanes; ++l) {
+        auto const chain = group * chaos_game_lanes + l;
+        auto const first = chain * chaos_game_chain_length;
+        keys[l] = counter_rng::stream(seed, first_chain + chain).key;
+        lengths[l] = first < num_positions ? std::min(chaos_game_chain_length, num_positions - first) : 0;
+        max_length = std::max(max_length, lengths[l]);
+        for (int d = 0; d < D; ++d) {
+            state[d * chaos_game_lanes + l] = component(start, d);
+        }
+    }
+
+    alignas(64) float tile[D * chaos_game_tile_steps * chaos_game_lanes];
+    advance(keys, 0, chaos_game_burn_in, state, tile);
+    for (std::size_t first = 0; first < max_length; first += chaos_game_tile_steps) {
+        auto const steps = std::min(chaos_game_tile_steps, max_length - first);
+        advance(keys, chaos_game_burn_in + static_cast<std::uint32_t>(first), steps, state, tile);
+        for (std::size_t l = 0; l < chaos_game_lanes; ++l) {
+            if (lengths[l] > first) {
+                store(group * chaos_game_lanes + l, first, std::min(steps, lengths[l] - first), tile, l);
+            }
+        }
+    }
+}
+
+// Runs all chains of `num_positions` points on up to `num_threads` threads,
+// chaos_game_lanes chains per work item.
+template <typename Vec, typename Advance, typename Store>
+void parallel_chains(
+    Vec start,
+    std::size_t first_chain,
+    std::size_t num_positions,
+    std::uint32_t seed,
+    unsigned num_threads,
+    Advance&& advance,
+    Store&& store)
+{
+    auto const num_chains = (num_positions + chaos_game_chain_length - 1) / chaos_game_chain_length;
+    auto const num_groups = (num_chains + chaos_game_lanes - 1) / chaos_game_lanes;
+    parallel_for(num_groups, num_threads, [&](std::size_t group) {
+        chaos_game_group(start, first_chain, num_positions, group, seed, advance, store);
+    });
+}
+
+// Interleaves the output tiles straight into the vertex layout.
+template <typename Vec>
+auto aos_store(std::span<Vec> positions)
+{
+    return [positions](std::size_t chain, std::size_t first, std::size_t steps, const float* tile, std::size_t l) {
+        auto* out = positions.data() + chain * chaos_game_chain_length + first;
+        for (std::size_t t = 0; t < steps; ++t) {
+            auto const* p = tile + t * chaos_game_lanes + l;
+            if constexpr (dimension<Vec> == 2) {
+                out[t] = vec2{p[0], p[chaos_game_tile_steps * chaos_game_lanes]};
+            } else {
+                out[t] = vec3{p[0], p[chaos_game_tile_steps * chaos_game_lanes], p[2 * chaos_game_tile_steps * chaos_game_lanes]};
+            }
+        }
+    };
+}
+
+// Transposes the output tiles into the component arrays.
+template <int D>
+auto soa_store(soa_points& points)
+{
+    float* components[] = {points.x.data(), points.y.data(), points.z.data()};
+    return [=](std::size_t chain, std::size_t first, std::size_t steps, const float* tile, std::size_t l) {
+        for (int d = 0; d < D; ++d) {
+            auto* out = components[d] + chain * chaos_game_chain_length + first;
+            auto const* in = tile + d * chaos_game_tile_steps * chaos_game_lanes + l;
+            for (std::size_t t = 0; t < steps; ++t) {
+                out[t] = in[t * chaos_game_lanes];
+            }
+        }
+    };
+}
+
+// Bins points of D components into `counts`, one histogram of `grid`.
+template <int D>
+class density_binner
+{
+public:
+    density_binner(const density_grid& grid, std::span<std::uint32_t> counts)
+        : counts{counts}
+        , origin{grid.min.x, grid.min.y, grid.min.z}
+        , scale{
+              static_cast<float>(grid.width) / (grid.max.x - grid.min.x),
+              static_cast<float>(grid.height) / (grid.max.y - grid.min.y),
+              static_cast<float>(grid.depth) / (grid.max.z - grid.min.z)}
+        , extent{grid.width, grid.height, grid.depth}
+    {
+    }
+
+    // Component d of the point is p[d * stride].
+    void add(const float* p, std::size_t stride = 1)
+    {
+        auto index = std::size_t{0};
+        auto bins = std::size_t{1};
+        for (int d = 0; d < D; ++d) {
+            auto const f = (p[d * stride] - origin[d]) * scale[d];
+            if (!(f >= 0.0f && f < static_cast<float>(extent[d]))) {
+                return;
+            }
+            index += bins * static_cast<std::size_t>(f);
+            bins *= extent[d];
+        }
+        ++counts[index];
+    }
+
+private:
+    std::span<std::uint32_t> counts;
+    float origin[3];
+    float scale[3];
+    std::size_t extent[3];
+};
+
+// Sums the histograms into the first of them, on up to `num_threads` threads.
+density merge_histograms(const density_grid& grid, std::vector<std::vector<std::uint32_t>>& histograms, unsigned num_threads);
+
+// Bins all chains of `num_positions` points, as parallel_chains generates
+// them, into one histogram per thread, each of which takes a contiguous range
+// of chain groups, and merges the histograms.
+template <typename Vec, typename Advance>
+density density_chains(
+    Vec start,
+    std::size_t num_positions,
+    std::uint32_t seed,
+    unsigned num_threads,
+    Advance&& advance,
+    density_grid grid)
+{
+    constexpr auto D = dimension<Vec>;
+    if constexpr (D == 2) {
+        grid.depth = 1;
+    }
+    auto const num_chains = (num_positions + chaos_game_chain_length - 1) / chaos_game_chain_length;
+    auto const num_groups = (num_chains + chaos_game_lanes - 1) / chaos_game_lanes;
+    auto const num_histograms = std::max<std::size_t>(1, std::min<std::size_t>(resolve_num_threads(num_threads), num_groups));
+
+    auto histograms = std::vector<std::vector<std::uint32_t>>(num_histograms);
+    parallel_for(num_histograms, num_threads, [&](std::size_t h) {
+        histograms[h].assign(grid.size(), 0);
+        auto binner = density_binner<D>{grid, histograms[h]};
+        auto const store = [&](std::size_t, std::size_t, std::size_t steps, const float* tile, std::size_t l) {
+            for (std::size_t t = 0; t < steps; ++t) {
+                binner.add(tile + t * chaos_game_lanes + l, chaos_game_tile_steps * chaos_game_lanes);
+            }
+        };
+        for (auto group = h * num_groups / num_histograms; group < (h + 1) * num_groups / num_histograms; ++group) {
+            chaos_game_group(start, 0, num_positions, group, seed, advance, store);
+        }
+    });
+    return merge_histograms(grid, histograms, num_threads);
+}
+
+} // namespace icg::detail
+
+#endif // ICG_CHAOS_GAME_KERNELS_H
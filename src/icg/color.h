@@ -0,0 +1,43 @@
+#ifndef ICG_COLOR_H
+#define ICG_COLOR_H
+
+#include "vector.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace icg {
+
+// Color packed into four bytes, read back by OpenGL as a normalized
+// GL_UNSIGNED_BYTE attribute. A quarter of the size of a float RGBA color.
+struct rgba8
+{
+    std::uint8_t r;
+    std::uint8_t g;
+    std::uint8_t b;
+    std::uint8_t a;
+};
+
+static_assert(sizeof(rgba8) == 4);
+
+// Maps [0, 1] to [0, 255], rounding to nearest and clamping values outside.
+constexpr std::uint8_t to_unorm8(float v)
+{
+    return static_cast<std::uint8_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+constexpr rgba8 pack_rgba8(float r, float g, float b, float a = 1.0f)
+{
+    return {to_unorm8(r), to_unorm8(g), to_unorm8(b), to_unorm8(a)};
+}
+
+constexpr rgba8 pack_rgba8(const vec3& c, float a = 1.0f) { return pack_rgba8(c.x, c.y, c.z, a); }
+constexpr rgba8 pack_rgba8(const vec4& c) { return pack_rgba8(c.x, c.y, c.z, c.w); }
+
+constexpr bool operator==(const rgba8& a, const rgba8& b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+} // namespace icg
+
+#endif // ICG_COLOR_H
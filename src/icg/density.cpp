@@ -0,0 +1,78 @@
+#include "density.h"
+#include "chaos_game_kernels.h"
+#include "parallel.h"
+#include <algorithm>
+
+namespace icg {
+
+namespace {
+
+// Bins per work item of the merge.
+constexpr std::size_t merge_block_size = std::size_t{1} << 16;
+
+template <typename Vec>
+density bin_points(std::span<const Vec> positions, density_grid grid)
+{
+    constexpr auto D = detail::dimension<Vec>;
+    if constexpr (D == 2) {
+        grid.depth = 1;
+    }
+    auto histograms = std::vector<std::vector<std::uint32_t>>(1, std::vector<std::uint32_t>(grid.size()));
+    auto binner = detail::density_binner<D>{grid, histograms[0]};
+    for (auto const& p : positions) {
+        binner.add(reinterpret_cast<const float*>(&p));
+    }
+    return detail::merge_histograms(grid, histograms, 1);
+}
+
+} // namespace
+
+density bin_points(std::span<const vec2> positions, const density_grid& grid)
+{
+    return bin_points<vec2>(positions, grid);
+}
+
+density bin_points(std::span<const vec3> positions, const density_grid& grid)
+{
+    return bin_points<vec3>(positions, grid);
+}
+
+namespace detail {
+
+density merge_histograms(const density_grid& grid, std::vector<std::vector<std::uint32_t>>& histograms, unsigned num_threads)
+{
+    auto& counts = histograms[0];
+    auto const num_blocks = (counts.size() + merge_block_size - 1) / merge_block_size;
+    auto max_counts = std::vector<std::uint32_t>(num_blocks);
+    auto totals = std::vector<std::uint64_t>(num_blocks);
+    parallel_for(num_blocks, num_threads, [&](std::size_t block) {
+        auto const first = block * merge_block_size;
+        auto const last = std::min(counts.size(), first + merge_block_size);
+        for (std::size_t h = 1; h < histograms.size(); ++h) {
+            auto const& other = histograms[h];
+            for (auto i = first; i < last; ++i) {
+                counts[i] += other[i];
+            }
+        }
+        auto max_count = std::uint32_t{0};
+        auto total = std::uint64_t{0};
+        for (auto i = first; i < last; ++i) {
+            max_count = std::max(max_count, counts[i]);
+            total += counts[i];
+        }
+        max_counts[block] = max_count;
+        totals[block] = total;
+    });
+
+    auto result = density{grid, std::move(counts)};
+    for (std::size_t block = 0; block < num_blocks; ++block) {
+        result.max_count = std::max(result.max_count, max_counts[block]);
+        result.total += totals[block];
+    }
+    histograms.clear();
+    return result;
+}
+
+} // namespace detail
+
+} // namespace icg
@@ -0,0 +1,57 @@
+#ifndef ICG_DENSITY_H
+#define ICG_DENSITY_H
+
+#include "ifs.h"
+#include "simd.h"
+#include "vector.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace icg {
+
+// Grid of width x height bins over the box [min, max], in depth layers along
+// z in 3D; 2D generators ignore the z bounds and take a single layer.
+struct density_grid
+{
+    vec3 min;
+    vec3 max;
+    std::size_t width;
+    std::size_t height;
+    std::size_t depth{1};
+
+    std::size_t size() const { return width * height * depth; }
+};
+
+// Number of points that fell into every bin of a grid, x fastest, then y,
+// then z. Points outside the grid are not counted.
+struct density
+{
+    density_grid grid;
+    std::vector<std::uint32_t> counts;
+    std::uint32_t max_count{0};
+    std::uint64_t total{0};
+};
+
+// Density of the point clouds of parallel_chaos_game and parallel_ifs, binned
+// as the chains are generated instead of being kept: every thread counts into
+// its own histogram, which are then summed in parallel. Memory and the cost
+// of drawing the result depend on the grid rather than the number of points,
+// and the counts are the same at any thread count and SIMD level.
+//
+// Needs num_threads * grid.size() * 4 bytes while the histograms are merged.
+density chaos_game_density(const std::array<vec2, 3>& vertices, std::size_t num_positions, std::uint32_t seed, const density_grid& grid, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+density chaos_game_density(const std::array<vec3, 4>& vertices, std::size_t num_positions, std::uint32_t seed, const density_grid& grid, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+
+density ifs_density(const ifs<2>& system, std::size_t num_positions, std::uint32_t seed, const density_grid& grid, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+density ifs_density(const ifs<3>& system, std::size_t num_positions, std::uint32_t seed, const density_grid& grid, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+
+// Bins already generated points, on a single thread.
+density bin_points(std::span<const vec2> positions, const density_grid& grid);
+density bin_points(std::span<const vec3> positions, const density_grid& grid);
+
+} // namespace icg
+
+#endif // ICG_DENSITY_H
@@ -0,0 +1,29 @@
+#include "dirty_ranges.h"
+#include <algorithm>
+
+namespace icg {
+
+void dirty_ranges::add(std::size_t first, std::size_t last)
+{
+    if (first >= last) {
+        return;
+    }
+
+    // first range that overlaps or touches [first, last), if any
+    auto begin = std::ranges::lower_bound(sorted, first, {}, &index_range::last);
+    auto end = begin;
+    while (end != sorted.end() && end->first <= last) {
+        first = std::min(first, end->first);
+        last = std::max(last, end->last);
+        ++end;
+    }
+
+    if (begin == end) {
+        sorted.insert(begin, index_range{first, last});
+    } else {
+        *begin = index_range{first, last};
+        sorted.erase(begin + 1, end);
+    }
+}
+
+} // namespace icg
@@ -0,0 +1,36 @@
+#ifndef ICG_DIRTY_RANGES_H
+#define ICG_DIRTY_RANGES_H
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace icg {
+
+// Half-open range [first, last) of elements.
+struct index_range
+{
+    std::size_t first;
+    std::size_t last;
+
+    std::size_t size() const { return last - first; }
+};
+
+// Set of modified element ranges, kept sorted with overlapping and adjacent
+// ranges merged, so each range can be uploaded with a single call.
+class dirty_ranges
+{
+public:
+    void add(std::size_t first, std::size_t last);
+    void clear() { sorted.clear(); }
+
+    bool empty() const { return sorted.empty(); }
+    std::span<const index_range> ranges() const { return sorted; }
+
+private:
+    std::vector<index_range> sorted;
+};
+
+} // namespace icg
+
+#endif // ICG_DIRTY_RANGES_H
@@ -0,0 +1,23 @@
+#include "draw_batch.h"
+#include <limits>
+#include <stdexcept>
+
+namespace icg {
+
+void draw_batch::add(std::size_t first, std::size_t count)
+{
+    constexpr auto max = static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+    if (first > max || count > max) {
+        throw std::length_error{"draw_batch::add of vertices past what a GLint addresses"};
+    }
+    first_vertices.push_back(static_cast<std::int32_t>(first));
+    vertex_counts.push_back(static_cast<std::int32_t>(count));
+}
+
+void draw_batch::clear()
+{
+    first_vertices.clear();
+    vertex_counts.clear();
+}
+
+} // namespace icg
@@ -0,0 +1,39 @@
+#ifndef ICG_DRAW_BATCH_H
+#define ICG_DRAW_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace icg {
+
+// Ranges of vertices drawn as separate primitives (triangle fans, say) with a
+// single glMultiDrawArrays call instead of one glDrawArrays call each. The
+// ranges are kept in the GLint/GLsizei arrays the call takes, so a batch only
+// changes when shapes are added and is never rebuilt per frame.
+class draw_batch
+{
+public:
+    // Adds the primitive of vertices [first, first + count). Throws
+    // std::length_error if `first` or `count` does not fit in a GLint.
+    void add(std::size_t first, std::size_t count);
+
+    void clear();
+
+    // Number of primitives, which is the number of draw calls the batch
+    // replaces.
+    std::size_t size() const { return first_vertices.size(); }
+    bool empty() const { return first_vertices.empty(); }
+
+    std::span<const std::int32_t> firsts() const { return first_vertices; }
+    std::span<const std::int32_t> counts() const { return vertex_counts; }
+
+private:
+    std::vector<std::int32_t> first_vertices;
+    std::vector<std::int32_t> vertex_counts;
+};
+
+} // namespace icg
+
+#endif // ICG_DRAW_BATCH_H
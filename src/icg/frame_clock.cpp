@@ -0,0 +1,46 @@
+#include "frame_clock.h"
+#include <algorithm>
+#include <atomic>
+
+namespace icg {
+
+namespace {
+
+std::atomic<double> fixed_step{0.0};
+
+} // namespace
+
+void set_default_fixed_step(double seconds)
+{
+    fixed_step.store(std::max(0.0, seconds));
+}
+
+double default_fixed_step()
+{
+    return fixed_step.load();
+}
+
+frame_clock::frame_clock()
+    : frame_clock{default_fixed_step()}
+{
+}
+
+frame_clock::frame_clock(double fixed_step)
+    : step{std::max(0.0, fixed_step)}
+{
+}
+
+float frame_clock::tick()
+{
+    auto dt = step;
+    if (!fixed()) {
+        auto const now = clock::now();
+        dt = started ? std::min(std::chrono::duration<double>(now - last).count(), max_frame_step) : 0.0;
+        last = now;
+    }
+    started = true;
+    total += dt;
+    return static_cast<float>(dt);
+}
+
+} // namespace icg
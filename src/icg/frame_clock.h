@@ -0,0 +1,47 @@
+#ifndef ICG_FRAME_CLOCK_H
+#define ICG_FRAME_CLOCK_H
+
+#include <chrono>
+
+namespace icg {
+
+// Time step of every frame_clock created without one of its own, in seconds;
+// 0 (the default) means real time. Set once at startup, e.g. for
+// deterministic offscreen runs.
+void set_default_fixed_step(double seconds);
+double default_fixed_step();
+
+// Longest step a real-time clock reports, so that a stall (a breakpoint, a
+// window being dragged) does not make animations jump.
+constexpr double max_frame_step = 0.25;
+
+// Time between frames for animations that advance by velocity times dt and so
+// run at the same speed whatever the frame rate. In real time it reads the
+// monotonic steady_clock; with a fixed step every frame advances by exactly
+// that much, so a run is the same frame for frame on any machine.
+class frame_clock
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    frame_clock();
+    explicit frame_clock(double fixed_step);
+
+    // Seconds since the previous tick, 0 at the first one in real time.
+    float tick();
+
+    // Seconds since the first tick.
+    double elapsed() const { return total; }
+
+    bool fixed() const { return step > 0.0; }
+
+private:
+    double step;
+    double total{0.0};
+    clock::time_point last{};
+    bool started{false};
+};
+
+} // namespace icg
+
+#endif // ICG_FRAME_CLOCK_H
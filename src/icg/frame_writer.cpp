@@ -0,0 +1,106 @@
+#include "frame_writer.h"
+#include "parallel.h"
+#include <fmt/core.h>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace icg {
+
+void write_ppm(const std::filesystem::path& path, const image& frame)
+{
+    auto const width = static_cast<std::size_t>(frame.width);
+    auto row = std::vector<char>(3 * width);
+    auto file = std::ofstream{path, std::ios::binary};
+    file << "P6\n" << frame.width << ' ' << frame.height << "\n255\n";
+    for (auto y = frame.height; y-- > 0;) {
+        auto const* pixel = frame.pixels.data() + static_cast<std::size_t>(y) * width;
+        for (std::size_t x = 0; x < width; ++x) {
+            row[3 * x] = static_cast<char>(pixel[x].r);
+            row[3 * x + 1] = static_cast<char>(pixel[x].g);
+            row[3 * x + 2] = static_cast<char>(pixel[x].b);
+        }
+        file.write(row.data(), static_cast<std::streamsize>(row.size()));
+    }
+    if (!file) {
+        throw std::runtime_error{"Failed to write " + path.string()};
+    }
+}
+
+frame_writer::frame_writer(std::filesystem::path directory, std::string prefix, unsigned num_threads, std::size_t max_pending)
+    : directory{std::move(directory)}
+    , prefix{std::move(prefix)}
+    , max_pending{std::max<std::size_t>(1, max_pending)}
+{
+    std::filesystem::create_directories(this->directory);
+    num_threads = resolve_num_threads(num_threads);
+    workers.reserve(num_threads);
+    for (unsigned t = 0; t < num_threads; ++t) {
+        workers.emplace_back([this] { work(); });
+    }
+}
+
+frame_writer::~frame_writer()
+{
+    {
+        auto const lock = std::lock_guard{mutex};
+        stopping = true;
+    }
+    queued.notify_all();
+}
+
+void frame_writer::submit(std::size_t index, image frame)
+{
+    {
+        auto lock = std::unique_lock{mutex};
+        done.wait(lock, [this] { return jobs.size() < max_pending; });
+        jobs.push_back({index, std::move(frame)});
+    }
+    queued.notify_one();
+}
+
+void frame_writer::finish()
+{
+    auto lock = std::unique_lock{mutex};
+    done.wait(lock, [this] { return jobs.empty() && in_progress == 0; });
+    if (error) {
+        std::rethrow_exception(std::exchange(error, nullptr));
+    }
+}
+
+std::filesystem::path frame_writer::path(std::size_t index) const
+{
+    return directory / fmt::format("{}_{:05}.ppm", prefix, index);
+}
+
+void frame_writer::work()
+{
+    auto lock = std::unique_lock{mutex};
+    while (true) {
+        queued.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+            return;
+        }
+        auto next = std::move(jobs.front());
+        jobs.pop_front();
+        ++in_progress;
+        lock.unlock();
+        done.notify_all();
+
+        try {
+            write_ppm(path(next.index), next.frame);
+        } catch (...) {
+            auto const error_lock = std::lock_guard{mutex};
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+
+        lock.lock();
+        --in_progress;
+        done.notify_all();
+    }
+}
+
+} // namespace icg
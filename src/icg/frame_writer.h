@@ -0,0 +1,77 @@
+#ifndef ICG_FRAME_WRITER_H
+#define ICG_FRAME_WRITER_H
+
+#include "color.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace icg {
+
+// Frame of width x height pixels, rows bottom to top as glReadPixels returns
+// them.
+struct image
+{
+    int width{0};
+    int height{0};
+    std::vector<rgba8> pixels;
+};
+
+// Writes `frame` as a binary PPM (P6), top row first and without alpha.
+void write_ppm(const std::filesystem::path& path, const image& frame);
+
+// Encodes frames to <directory>/<prefix>_<index>.ppm on a pool of worker
+// threads, so that rendering goes on while earlier frames are written. submit
+// only waits if `max_pending` frames are still queued, which bounds memory
+// when the disk cannot keep up. The directory is created if needed.
+class frame_writer
+{
+public:
+    frame_writer(std::filesystem::path directory, std::string prefix, unsigned num_threads = 0, std::size_t max_pending = 64);
+
+    frame_writer(const frame_writer&) = delete;
+    frame_writer& operator=(const frame_writer&) = delete;
+
+    // Writes the frames still queued before returning.
+    ~frame_writer();
+
+    void submit(std::size_t index, image frame);
+
+    // Waits until every submitted frame is written. Rethrows the first error
+    // a worker ran into.
+    void finish();
+
+    std::filesystem::path path(std::size_t index) const;
+
+private:
+    struct job
+    {
+        std::size_t index;
+        image frame;
+    };
+
+    void work();
+
+    std::filesystem::path directory;
+    std::string prefix;
+    std::size_t max_pending;
+
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable done;
+    std::deque<job> jobs;
+    std::size_t in_progress{0};
+    std::exception_ptr error;
+    bool stopping{false};
+    std::vector<std::jthread> workers;
+};
+
+} // namespace icg
+
+#endif // ICG_FRAME_WRITER_H
@@ -0,0 +1,78 @@
+#include "free_list.h"
+#include <iterator>
+#include <stdexcept>
+
+namespace icg {
+
+std::optional<std::size_t> free_list::allocate(std::size_t count)
+{
+    if (count == 0) {
+        return std::nullopt;
+    }
+
+    for (auto it = by_size.lower_bound(count); it != by_size.end();) {
+        auto const size = it->first;
+        auto& firsts = it->second;
+        auto const first = firsts.back();
+        firsts.pop_back();
+        if (firsts.empty()) {
+            it = by_size.erase(it);
+        }
+
+        auto const block = blocks.find(first);
+        if (block == blocks.end() || block->second != size) {
+            continue;
+        }
+        auto const next = erase(block);
+
+        // give back what is left of a larger block, whose neighbors are in use
+        if (size > count) {
+            insert(next, first + count, size - count);
+        }
+        return first;
+    }
+    return std::nullopt;
+}
+
+void free_list::release(std::size_t first, std::size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    // the free blocks on either side, if any
+    auto next = blocks.lower_bound(first);
+    auto const previous = next == blocks.begin() ? blocks.end() : std::prev(next);
+    if ((next != blocks.end() && next->first < first + count)
+        || (previous != blocks.end() && previous->first + previous->second > first)) {
+        throw std::invalid_argument{"free_list::release of elements already free"};
+    }
+
+    auto merged_first = first;
+    auto merged_count = count;
+    if (next != blocks.end() && next->first == first + count) {
+        merged_count += next->second;
+        next = erase(next);
+    }
+    if (previous != blocks.end() && previous->first + previous->second == first) {
+        merged_first = previous->first;
+        merged_count += previous->second;
+        next = erase(previous);
+    }
+    insert(next, merged_first, merged_count);
+}
+
+void free_list::insert(block_iterator next, std::size_t first, std::size_t count)
+{
+    blocks.emplace_hint(next, first, count);
+    by_size[count].push_back(first);
+    num_free += count;
+}
+
+free_list::block_iterator free_list::erase(block_iterator block)
+{
+    num_free -= block->second;
+    return blocks.erase(block);
+}
+
+} // namespace icg
@@ -0,0 +1,49 @@
+#ifndef ICG_FREE_LIST_H
+#define ICG_FREE_LIST_H
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace icg {
+
+// Blocks of released elements of an array, handed out again best fit first so
+// deleted primitives leave no holes behind once new ones take their place.
+// Released neighbors are merged, so a large primitive fits where several
+// small ones were released.
+class free_list
+{
+public:
+    // First element of a free block of `count` elements, split off the
+    // smallest block large enough, or nothing if there is none.
+    std::optional<std::size_t> allocate(std::size_t count);
+
+    // Throws std::invalid_argument if any of the elements is free already.
+    void release(std::size_t first, std::size_t count);
+
+    // Number of free elements.
+    std::size_t size() const { return num_free; }
+
+    // Number of free blocks, after merging.
+    std::size_t num_blocks() const { return blocks.size(); }
+
+private:
+    using block_iterator = std::map<std::size_t, std::size_t>::iterator;
+
+    // `next` is the block after the one inserted, and the one after the
+    // erased one is returned, so that neither looks up a known position
+    void insert(block_iterator next, std::size_t first, std::size_t count);
+    block_iterator erase(block_iterator block);
+
+    // sizes of the free blocks by first element
+    std::map<std::size_t, std::size_t> blocks;
+    // first elements of the free blocks by block size; a block merged or
+    // allocated since is left behind and skipped once allocate comes to it
+    std::map<std::size_t, std::vector<std::size_t>> by_size;
+    std::size_t num_free{0};
+};
+
+} // namespace icg
+
+#endif // ICG_FREE_LIST_H
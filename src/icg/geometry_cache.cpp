@@ -0,0 +1,359 @@
+#include "geometry_cache.h"
+#include "program_cache.h"
+#include <algorithm>
+#include <bit>
+#include <fmt/core.h>
+#include <fstream>
+#include <random>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace icg {
+
+namespace {
+
+constexpr std::array<char, 8> magic = {'I', 'C', 'G', 'G', 'E', 'O', 'M', '\0'};
+constexpr std::uint32_t version = 1;
+// Read back differently on a machine of the other endianness.
+constexpr std::uint32_t byte_order = 0x01020304;
+// Sections are aligned for the widest vector loads.
+constexpr std::uint64_t alignment = 64;
+constexpr std::uint32_t max_sections = 16;
+
+// The file starts with this header, followed by a section_header per section,
+// the generator name and the parameters of the key, and then the sections.
+struct file_header
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t key;
+    std::uint64_t seed;
+    std::uint64_t generator_size;
+    std::uint64_t params_size;
+    std::uint64_t file_size;
+    std::uint32_t num_sections;
+    std::uint32_t reserved;
+};
+
+struct section_header
+{
+    element_layout layout;
+    std::uint32_t reserved;
+    std::uint64_t count;
+    std::uint64_t offset;
+    std::uint64_t checksum;
+};
+
+static_assert(std::is_trivially_copyable_v<file_header> && std::is_trivially_copyable_v<section_header>);
+
+constexpr std::uint64_t align_up(std::uint64_t offset)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Checksum of the sections: four independent multiply-rotate lanes over 8-byte
+// words, so that verifying an entry keeps up with reading it from the page
+// cache.
+std::uint64_t checksum(std::span<const std::byte> bytes)
+{
+    constexpr std::uint64_t p1 = 0x9e3779b185ebca87;
+    constexpr std::uint64_t p2 = 0xc2b2ae3d27d4eb4f;
+    auto const mix = [](std::uint64_t acc, std::uint64_t word) {
+        return std::rotl(acc + word * p2, 31) * p1;
+    };
+    auto const word = [&](std::size_t i) {
+        auto w = std::uint64_t{};
+        std::memcpy(&w, bytes.data() + i, sizeof(w));
+        return w;
+    };
+
+    std::uint64_t lanes[4] = {p1 + p2, p2, 0, std::uint64_t{0} - p1};
+    auto i = std::size_t{0};
+    for (; i + 32 <= bytes.size(); i += 32) {
+        for (int l = 0; l < 4; ++l) {
+            lanes[l] = mix(lanes[l], word(i + 8 * l));
+        }
+    }
+    auto hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+    for (; i + 8 <= bytes.size(); i += 8) {
+        hash = std::rotl(hash ^ mix(0, word(i)), 27) * p1;
+    }
+    for (; i < bytes.size(); ++i) {
+        hash = (hash ^ static_cast<std::uint64_t>(bytes[i])) * 0x100000001b3;
+    }
+    hash ^= bytes.size();
+    hash = (hash ^ (hash >> 33)) * p2;
+    return hash ^ (hash >> 29);
+}
+
+template <typename T>
+void write(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+// Read-only mapping of a whole file, unmapped when the last entry pointing
+// into it goes away.
+class geometry_entry::mapping
+{
+public:
+    // The mapping of `path`, or nullptr if it cannot be opened or is empty.
+    static std::shared_ptr<const mapping> open(const std::filesystem::path& path)
+    {
+        auto m = std::shared_ptr<mapping>{new mapping};
+#if defined(_WIN32)
+        auto const file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+        auto size = LARGE_INTEGER{};
+        auto const mapping_handle = GetFileSizeEx(file, &size) && size.QuadPart > 0
+            ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+            : nullptr;
+        CloseHandle(file);
+        if (mapping_handle == nullptr) {
+            return nullptr;
+        }
+        auto* data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping_handle);
+        if (data == nullptr) {
+            return nullptr;
+        }
+        m->data = static_cast<const std::byte*>(data);
+        m->size = static_cast<std::size_t>(size.QuadPart);
+#else
+        auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat status{};
+        auto* data = fstat(fd, &status) == 0 && status.st_size > 0
+            ? mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0)
+            : MAP_FAILED;
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+        // the checksum and the upload read it front to back
+        madvise(data, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+        m->data = static_cast<const std::byte*>(data);
+        m->size = static_cast<std::size_t>(status.st_size);
+#endif
+        return m;
+    }
+
+    mapping(const mapping&) = delete;
+    mapping& operator=(const mapping&) = delete;
+
+    ~mapping()
+    {
+        if (data != nullptr) {
+#if defined(_WIN32)
+            UnmapViewOfFile(data);
+#else
+            munmap(const_cast<std::byte*>(data), size);
+#endif
+        }
+    }
+
+    std::span<const std::byte> bytes() const { return {data, size}; }
+
+private:
+    mapping() = default;
+
+    const std::byte* data{nullptr};
+    std::size_t size{0};
+};
+
+geometry_key::geometry_key(std::string_view generator, std::uint32_t version, std::uint64_t seed)
+    : name{generator}
+    , seed_value{seed}
+    , parameters(sizeof(version))
+{
+    std::memcpy(parameters.data(), &version, sizeof(version));
+}
+
+std::uint64_t geometry_key::hash() const
+{
+    auto const seed_bytes = std::as_bytes(std::span{&seed_value, 1});
+    auto const sources = std::array<std::string_view, 2>{
+        std::string_view{reinterpret_cast<const char*>(seed_bytes.data()), seed_bytes.size()},
+        std::string_view{reinterpret_cast<const char*>(parameters.data()), parameters.size()}};
+    return program_cache_key(sources, name);
+}
+
+element_layout make_element_layout(std::size_t size, std::string_view components)
+{
+    auto layout = element_layout{static_cast<std::uint32_t>(size)};
+    auto total = std::size_t{0};
+    for (auto const c : components) {
+        switch (c) {
+            case 'f':
+            case 'I':
+                total += 4;
+                break;
+            case 'H':
+                total += 2;
+                break;
+            case 'B':
+                total += 1;
+                break;
+            default:
+                throw std::invalid_argument{"Unknown component " + std::string{c} + " in element layout " + std::string{components}};
+        }
+    }
+    if (total != size || components.size() >= layout.format.size()) {
+        throw std::invalid_argument{fmt::format("Element layout {} does not match elements of {} bytes", components, size)};
+    }
+    components.copy(layout.format.data(), components.size());
+    return layout;
+}
+
+geometry_entry::geometry_entry(std::shared_ptr<const mapping> file, std::vector<section_info> sections)
+    : file{std::move(file)}
+    , sections{std::move(sections)}
+{
+}
+
+geometry_cache::geometry_cache(std::filesystem::path directory)
+    : root{std::move(directory)}
+{
+}
+
+std::filesystem::path geometry_cache::path(const geometry_key& key) const
+{
+    return root / fmt::format("{:016x}.geom", key.hash());
+}
+
+std::optional<geometry_entry> geometry_cache::load(const geometry_key& key)
+{
+    auto const file = geometry_entry::mapping::open(path(key));
+    if (!file) {
+        ++counts.misses;
+        return std::nullopt;
+    }
+
+    // Every offset and size is checked against the file before it is used,
+    // so that a truncated or corrupt entry is rejected rather than read past.
+    auto const bytes = file->bytes();
+    auto const validate = [&]() -> std::optional<std::vector<geometry_entry::section_info>> {
+        auto h = file_header{};
+        if (bytes.size() < sizeof(h)) {
+            return std::nullopt;
+        }
+        std::memcpy(&h, bytes.data(), sizeof(h));
+        if (h.magic != magic || h.version != version || h.byte_order != byte_order || h.file_size != bytes.size()
+            || h.key != key.hash() || h.seed != key.seed() || h.num_sections > max_sections
+            || h.generator_size != key.generator().size() || h.params_size != key.params().size()) {
+            return std::nullopt;
+        }
+        auto offset = std::uint64_t{sizeof(h)} + h.num_sections * sizeof(section_header);
+        if (offset + h.generator_size + h.params_size > bytes.size()
+            || std::memcmp(bytes.data() + offset, key.generator().data(), h.generator_size) != 0
+            || std::memcmp(bytes.data() + offset + h.generator_size, key.params().data(), h.params_size) != 0) {
+            return std::nullopt;
+        }
+
+        auto sections = std::vector<geometry_entry::section_info>{};
+        for (std::uint32_t i = 0; i < h.num_sections; ++i) {
+            auto s = section_header{};
+            std::memcpy(&s, bytes.data() + sizeof(h) + i * sizeof(s), sizeof(s));
+            if (s.layout.size == 0 || s.layout.format.back() != '\0' || s.offset % alignment != 0 || s.offset > bytes.size()
+                || s.count > (bytes.size() - s.offset) / s.layout.size) {
+                return std::nullopt;
+            }
+            auto const data = bytes.subspan(s.offset, s.count * s.layout.size);
+            if (checksum(data) != s.checksum) {
+                return std::nullopt;
+            }
+            sections.push_back({s.layout, s.count, data.data()});
+        }
+        return sections;
+    };
+
+    auto sections = validate();
+    if (!sections) {
+        ++counts.rejected;
+        ++counts.misses;
+        return std::nullopt;
+    }
+    ++counts.hits;
+    return geometry_entry{file, std::move(*sections)};
+}
+
+bool geometry_cache::store(const geometry_key& key, std::span<const geometry_section> sections)
+{
+    if (sections.size() > max_sections) {
+        return false;
+    }
+    auto error = std::error_code{};
+    std::filesystem::create_directories(root, error);
+    if (error) {
+        return false;
+    }
+
+    auto h = file_header{magic, version, byte_order, key.hash(), key.seed(), key.generator().size(), key.params().size(),
+        0, static_cast<std::uint32_t>(sections.size()), 0};
+    auto headers = std::vector<section_header>{};
+    auto offset = align_up(sizeof(h) + sections.size() * sizeof(section_header) + h.generator_size + h.params_size);
+    for (auto const& s : sections) {
+        headers.push_back({s.layout, 0, s.count, offset, checksum(s.data)});
+        offset = align_up(offset + s.data.size());
+    }
+    h.file_size = headers.empty() ? offset : headers.back().offset + sections.back().data.size();
+
+    auto const target = path(key);
+    auto temporary = target;
+    temporary += fmt::format(".{:08x}.tmp", std::random_device{}());
+    {
+        auto file = std::ofstream{temporary, std::ios::binary | std::ios::trunc};
+        write(file, h);
+        for (auto const& s : headers) {
+            write(file, s);
+        }
+        file.write(key.generator().data(), static_cast<std::streamsize>(key.generator().size()));
+        file.write(reinterpret_cast<const char*>(key.params().data()), static_cast<std::streamsize>(key.params().size()));
+        for (std::size_t i = 0; i < sections.size(); ++i) {
+            auto const padding = std::array<char, alignment>{};
+            auto const position = static_cast<std::uint64_t>(file.tellp());
+            file.write(padding.data(), static_cast<std::streamsize>(headers[i].offset - position));
+            file.write(reinterpret_cast<const char*>(sections[i].data.data()), static_cast<std::streamsize>(sections[i].data.size()));
+        }
+        if (!file) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(temporary, target, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+std::filesystem::path default_geometry_cache_directory()
+{
+    return default_program_cache_directory().parent_path() / "geometry";
+}
+
+geometry_cache& default_geometry_cache()
+{
+    static auto cache = geometry_cache{default_geometry_cache_directory()};
+    return cache;
+}
+
+} // namespace icg
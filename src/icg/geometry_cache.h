@@ -0,0 +1,177 @@
+#ifndef ICG_GEOMETRY_CACHE_H
+#define ICG_GEOMETRY_CACHE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace icg {
+
+// What a cache entry was generated from: the name of the generator, the
+// version of its output, its seed and every other parameter its output
+// depends on, e.g. the vertices and the number of points. Entries are looked
+// up by the hash of all of them and only load for the very same key. A
+// generator bumps its version, such as divide_triangle_version, whenever its
+// output changes for the same parameters, so that stale entries are not
+// loaded anymore.
+class geometry_key
+{
+public:
+    geometry_key(std::string_view generator, std::uint32_t version, std::uint64_t seed = 0);
+
+    // Appends a parameter, a trivially copyable value such as a number, a
+    // vector or an array of vertices.
+    template <typename T>
+    geometry_key& add(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        auto const bytes = std::as_bytes(std::span{&value, 1});
+        parameters.insert(parameters.end(), bytes.begin(), bytes.end());
+        return *this;
+    }
+
+    std::uint64_t hash() const;
+
+    const std::string& generator() const { return name; }
+    std::uint64_t seed() const { return seed_value; }
+    std::span<const std::byte> params() const { return parameters; }
+
+private:
+    std::string name;
+    std::uint64_t seed_value;
+    std::vector<std::byte> parameters;
+};
+
+// Layout of the elements of a section of an entry: their size and one letter
+// per component, 'f' for float, 'B' for std::uint8_t, 'H' for std::uint16_t
+// and 'I' for std::uint32_t, e.g. "fff" for icg::vec3. It is stored with the
+// section, so that a loader can tell e.g. 16-bit from 32-bit indices.
+struct element_layout
+{
+    std::uint32_t size{0};
+    std::array<char, 16> format{};
+
+    std::string_view components() const { return {format.data(), std::strlen(format.data())}; }
+
+    bool operator==(const element_layout&) const = default;
+};
+
+// Layout of elements of `size` bytes with the given components, which must
+// add up to the size. Throws std::invalid_argument otherwise.
+element_layout make_element_layout(std::size_t size, std::string_view components);
+
+template <typename T>
+element_layout layout_of(std::string_view components)
+{
+    return make_element_layout(sizeof(T), components);
+}
+
+// One array of elements of an entry to store.
+struct geometry_section
+{
+    element_layout layout;
+    std::size_t count;
+    std::span<const std::byte> data;
+};
+
+template <typename T>
+geometry_section section_of(std::span<const T> elements, std::string_view components)
+{
+    return {layout_of<T>(components), elements.size(), std::as_bytes(elements)};
+}
+
+// Entry loaded from a geometry_cache. Its sections point straight into the
+// memory-mapped file, which stays mapped as long as the entry lives, so they
+// can be handed to tinygl::buffer::create as they are.
+class geometry_entry
+{
+public:
+    struct section_info
+    {
+        element_layout layout;
+        std::size_t count;
+        const std::byte* data;
+    };
+
+    class mapping;
+
+    geometry_entry(std::shared_ptr<const mapping> file, std::vector<section_info> sections);
+
+    std::size_t size() const { return sections.size(); }
+    const element_layout& layout(std::size_t i) const { return sections.at(i).layout; }
+    std::size_t count(std::size_t i) const { return sections.at(i).count; }
+
+    // The elements of section i, which must have been stored with sizeof(T)
+    // bytes each.
+    template <typename T>
+    std::span<const T> elements(std::size_t i) const
+    {
+        auto const& s = sections.at(i);
+        if (s.layout.size != sizeof(T)) {
+            throw std::invalid_argument{"Geometry section element size mismatch"};
+        }
+        return {reinterpret_cast<const T*>(s.data), s.count};
+    }
+
+private:
+    std::shared_ptr<const mapping> file;
+    std::vector<section_info> sections;
+};
+
+// Hits and misses of a geometry_cache. A rejected entry was found but did not
+// validate, and counts as a miss as well.
+struct geometry_cache_stats
+{
+    std::size_t hits{0};
+    std::size_t misses{0};
+    std::size_t rejected{0};
+};
+
+// Directory of generated geometry, one file per key, so that demos generate
+// it once and then map it on every later run without any parsing. A file
+// holds a versioned header with the generator, seed and parameters of the
+// key, then the layout, count and checksum of each section, followed by the
+// sections themselves at 64-byte aligned offsets. A stale, truncated or
+// corrupt entry is detected and ignored. Entries are written to a temporary
+// file first and renamed into place, like those of the program_cache.
+class geometry_cache
+{
+public:
+    explicit geometry_cache(std::filesystem::path directory);
+
+    // The entry stored under `key`, if any is there and valid.
+    std::optional<geometry_entry> load(const geometry_key& key);
+
+    // Stores the sections under `key`. Failing to write the cache is not an
+    // error for the caller, which has the geometry already, so it only
+    // returns false.
+    bool store(const geometry_key& key, std::span<const geometry_section> sections);
+
+    std::filesystem::path path(const geometry_key& key) const;
+    const std::filesystem::path& directory() const { return root; }
+    const geometry_cache_stats& stats() const { return counts; }
+
+private:
+    std::filesystem::path root;
+    geometry_cache_stats counts;
+};
+
+// The geometry directory next to default_program_cache_directory().
+std::filesystem::path default_geometry_cache_directory();
+
+// Cache every demo shares, in default_geometry_cache_directory().
+geometry_cache& default_geometry_cache();
+
+} // namespace icg
+
+#endif // ICG_GEOMETRY_CACHE_H
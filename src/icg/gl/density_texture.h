@@ -0,0 +1,59 @@
+#ifndef ICG_GL_DENSITY_TEXTURE_H
+#define ICG_GL_DENSITY_TEXTURE_H
+
+#include <icg/density.h>
+#include <tinygl/tinygl.h>
+#include <cstdint>
+#include <stdexcept>
+
+namespace icg::gl {
+
+// 2D density grid uploaded as a single integer texture (GL_R32UI), which a
+// fullscreen pass tone-maps instead of drawing the points themselves: the
+// upload and the draw cost the same however many points were binned.
+class density_texture
+{
+public:
+    density_texture() { glGenTextures(1, &texture); }
+
+    density_texture(const density_texture&) = delete;
+    density_texture& operator=(const density_texture&) = delete;
+
+    ~density_texture() { glDeleteTextures(1, &texture); }
+
+    void upload(const density& d)
+    {
+        if (d.grid.depth != 1) {
+            throw std::invalid_argument{"Only 2D densities can be uploaded"};
+        }
+        glBindTexture(GL_TEXTURE_2D, texture);
+        // integer textures cannot be filtered
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(
+            GL_TEXTURE_2D, 0, GL_R32UI,
+            static_cast<GLsizei>(d.grid.width), static_cast<GLsizei>(d.grid.height), 0,
+            GL_RED_INTEGER, GL_UNSIGNED_INT, d.counts.data());
+        max = d.max_count;
+    }
+
+    void bind(GLuint unit)
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+
+    // Highest count of the last upload, which the tone mapping scales to.
+    std::uint32_t max_count() const { return max; }
+
+private:
+    GLuint texture{0};
+    std::uint32_t max{0};
+};
+
+} // namespace icg::gl
+
+#endif // ICG_GL_DENSITY_TEXTURE_H
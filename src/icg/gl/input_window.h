@@ -0,0 +1,214 @@
+#ifndef ICG_GL_INPUT_WINDOW_H
+#define ICG_GL_INPUT_WINDOW_H
+
+#include <icg/input_log.h>
+#include <tinygl/tinygl.h>
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace icg::gl {
+
+// Window whose key and mouse button callbacks, and the cursor position they
+// read, go through an input_session: with a recording every event is also
+// written to the log, with a replay the window's own input is ignored and
+// the logged events are fed to the same callbacks instead. Demos derive from
+// it in place of tinygl::window and register their callbacks as before; the
+// replay advances in poll_input, which input_driven calls every frame.
+//
+// Events that ImGui captures never reach the callbacks, and ImGui itself is
+// not replayed: a demo reports the actions of its controls with ui_action
+// and applies them in its ui callback, so that they are recorded and
+// replayed like the rest of the input.
+class input_window : public tinygl::window
+{
+public:
+    using key_callback = std::function<void(tinygl::keyboard::key, int, tinygl::input::action, tinygl::input::modifier)>;
+    using mouse_button_callback = std::function<void(tinygl::mouse::button, tinygl::input::action, tinygl::input::modifier)>;
+    using ui_callback = std::function<void(std::int32_t, std::int32_t)>;
+
+    using tinygl::window::window;
+
+    void set_key_callback(key_callback f)
+    {
+        on_key = std::move(f);
+        tinygl::window::set_key_callback([this](
+            tinygl::keyboard::key key,
+            int scancode,
+            tinygl::input::action action,
+            tinygl::input::modifier mods) {
+            if (replay || ImGui::GetIO().WantCaptureKeyboard) {
+                return;
+            }
+            auto e = event(input_kind::key, static_cast<std::int32_t>(key), action, mods);
+            e.scancode = scancode;
+            record(e);
+            on_key(key, scancode, action, mods);
+        });
+    }
+
+    void set_mouse_button_callback(mouse_button_callback f)
+    {
+        on_mouse_button = std::move(f);
+        tinygl::window::set_mouse_button_callback([this](
+            tinygl::mouse::button button,
+            tinygl::input::action action,
+            tinygl::input::modifier mods) {
+            if (replay || ImGui::GetIO().WantCaptureMouse) {
+                return;
+            }
+            record(event(input_kind::mouse_button, static_cast<std::int32_t>(button), action, mods));
+            on_mouse_button(button, action, mods);
+        });
+    }
+
+    void set_ui_callback(ui_callback f) { on_ui = std::move(f); }
+
+    // Reports that the UI set `control`, an id of the demo's choosing, to
+    // `value`. Records it and hands it to the ui callback, unless a replay is
+    // running, which hands the recorded actions to it instead.
+    void ui_action(std::int32_t control, std::int32_t value)
+    {
+        if (replay) {
+            return;
+        }
+        auto e = event(input_kind::ui, control, {}, {});
+        e.scancode = value;
+        record(e);
+        if (on_ui) {
+            on_ui(control, value);
+        }
+    }
+
+    // The replayed cursor position during a replay.
+    template <typename T>
+    std::pair<T, T> get_cursor_pos()
+    {
+        if (replay) {
+            return {static_cast<T>(cursor.first), static_cast<T>(cursor.second)};
+        }
+        return tinygl::window::get_cursor_pos<T>();
+    }
+
+    // Called once a frame: records a cursor event if the cursor moved, or
+    // hands the events that are due to the callbacks, closing the window once
+    // the replay is over.
+    void poll_input()
+    {
+        if (recorder) {
+            auto const position = tinygl::window::get_cursor_pos<float>();
+            if (position != cursor) {
+                cursor = position;
+                record(event(input_kind::cursor, 0, {}, {}));
+            }
+        }
+        if (replay && !replay->done()) {
+            auto const events = session.fast ? replay->next_frame() : replay->due(seconds());
+            for (auto const& e : events) {
+                dispatch(e);
+            }
+            if (replay->done()) {
+                spdlog::info("Replayed {} input events from {}", replay->size(), session.replay.string());
+                set_should_close(true);
+            }
+        }
+        ++frame;
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    static std::optional<input_log_writer> open_recorder(const input_session& s)
+    {
+        if (s.record.empty()) {
+            return std::nullopt;
+        }
+        return std::optional<input_log_writer>{std::in_place, s.record};
+    }
+
+    static std::optional<input_replay> open_replay(const input_session& s)
+    {
+        if (s.replay.empty()) {
+            return std::nullopt;
+        }
+        return input_replay{read_input_log(s.replay)};
+    }
+
+    double seconds() const { return std::chrono::duration<double>(clock::now() - start).count(); }
+
+    input_event event(input_kind kind, std::int32_t code, tinygl::input::action action, tinygl::input::modifier mods)
+    {
+        if (kind == input_kind::mouse_button) {
+            cursor = tinygl::window::get_cursor_pos<float>();
+        }
+        auto e = input_event{};
+        e.seconds = seconds();
+        e.frame = frame;
+        e.code = code;
+        e.x = cursor.first;
+        e.y = cursor.second;
+        e.kind = kind;
+        e.action = static_cast<std::uint8_t>(action);
+        e.mods = static_cast<std::uint16_t>(mods);
+        return e;
+    }
+
+    void record(const input_event& e)
+    {
+        if (recorder) {
+            recorder->write(e);
+        }
+    }
+
+    void dispatch(const input_event& e)
+    {
+        cursor = {e.x, e.y};
+        auto const action = static_cast<tinygl::input::action>(e.action);
+        auto const mods = static_cast<tinygl::input::modifier>(e.mods);
+        if (e.kind == input_kind::key && on_key) {
+            on_key(static_cast<tinygl::keyboard::key>(e.code), e.scancode, action, mods);
+        } else if (e.kind == input_kind::mouse_button && on_mouse_button) {
+            on_mouse_button(static_cast<tinygl::mouse::button>(e.code), action, mods);
+        } else if (e.kind == input_kind::ui && on_ui) {
+            on_ui(e.code, e.scancode);
+        }
+    }
+
+    input_session session{default_input_session()};
+    std::optional<input_log_writer> recorder{open_recorder(session)};
+    std::optional<input_replay> replay{open_replay(session)};
+    key_callback on_key;
+    mouse_button_callback on_mouse_button;
+    ui_callback on_ui;
+    std::pair<float, float> cursor{0.0f, 0.0f};
+    std::uint32_t frame{0};
+    clock::time_point start{clock::now()};
+};
+
+// Window that polls its input_window at the start of every frame.
+template <typename Window>
+class polled_input_window : public Window
+{
+public:
+    using Window::Window;
+
+    void process_input() override
+    {
+        this->poll_input();
+        Window::process_input();
+    }
+};
+
+// `Window` wrapped so that its recorded input is polled, if it is an
+// input_window, and `Window` itself otherwise.
+template <typename Window>
+using input_driven = std::conditional_t<std::derived_from<Window, input_window>, polled_input_window<Window>, Window>;
+
+} // namespace icg::gl
+
+#endif // ICG_GL_INPUT_WINDOW_H
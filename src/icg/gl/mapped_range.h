@@ -0,0 +1,103 @@
+#ifndef ICG_GL_MAPPED_RANGE_H
+#define ICG_GL_MAPPED_RANGE_H
+
+#include <icg/chaos_game.h>
+#include <tinygl/tinygl.h>
+#include <spdlog/spdlog.h>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+
+namespace icg::gl {
+
+// The glGet parameter of the buffer bound to `target`.
+constexpr GLenum buffer_binding(GLenum target)
+{
+    switch (target) {
+    case GL_ARRAY_BUFFER: return GL_ARRAY_BUFFER_BINDING;
+    case GL_ELEMENT_ARRAY_BUFFER: return GL_ELEMENT_ARRAY_BUFFER_BINDING;
+    case GL_COPY_READ_BUFFER: return GL_COPY_READ_BUFFER_BINDING;
+    case GL_COPY_WRITE_BUFFER: return GL_COPY_WRITE_BUFFER_BINDING;
+    case GL_PIXEL_PACK_BUFFER: return GL_PIXEL_PACK_BUFFER_BINDING;
+    case GL_PIXEL_UNPACK_BUFFER: return GL_PIXEL_UNPACK_BUFFER_BINDING;
+    case GL_TRANSFORM_FEEDBACK_BUFFER: return GL_TRANSFORM_FEEDBACK_BUFFER_BINDING;
+    case GL_UNIFORM_BUFFER: return GL_UNIFORM_BUFFER_BINDING;
+    default: throw std::invalid_argument{"Not a buffer binding target"};
+    }
+}
+
+// Name of the buffer bound to `target`.
+inline GLuint bound_buffer(GLenum target)
+{
+    auto name = GLint{0};
+    glGetIntegerv(buffer_binding(target), &name);
+    return static_cast<GLuint>(name);
+}
+
+// Write-only mapping of elements [first, first + count) of the buffer
+// currently bound to `target`, unmapped again when it goes out of scope. The
+// previous contents of the range are discarded unless `access` says otherwise.
+// The buffer is rebound for the unmap, so binding another one to `target`
+// meanwhile is fine; the binding is put back afterwards.
+template <typename T>
+class mapped_range
+{
+public:
+    mapped_range(
+        GLenum target,
+        std::size_t first,
+        std::size_t count,
+        GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT)
+        : target{target}
+        , buffer{bound_buffer(target)}
+    {
+        auto* data = glMapBufferRange(
+            target,
+            static_cast<GLintptr>(sizeof(T) * first),
+            static_cast<GLsizeiptr>(sizeof(T) * count),
+            access);
+        if (data == nullptr) {
+            throw std::runtime_error{"Failed to map buffer range"};
+        }
+        elements = std::span<T>{static_cast<T*>(data), count};
+    }
+
+    mapped_range(const mapped_range&) = delete;
+    mapped_range& operator=(const mapped_range&) = delete;
+
+    ~mapped_range()
+    {
+        auto const bound = bound_buffer(target);
+        glBindBuffer(target, buffer);
+        // the contents of the whole buffer are undefined after a failed unmap,
+        // e.g. when the display mode changed while it was mapped
+        if (glUnmapBuffer(target) == GL_FALSE) {
+            spdlog::error("Buffer {} lost its contents while mapped", buffer);
+        }
+        glBindBuffer(target, bound);
+    }
+
+    std::span<T> span() const { return elements; }
+
+private:
+    GLenum target;
+    GLuint buffer;
+    std::span<T> elements{};
+};
+
+// Allocates `buffer` for the whole point cloud of `stream` and generates it
+// chunk by chunk straight into mapped ranges of the buffer.
+template <typename Vec, std::size_t N>
+void stream_into(tinygl::buffer& buffer, chaos_game_stream<Vec, N>& stream)
+{
+    buffer.bind();
+    buffer.create(sizeof(Vec) * stream.size());
+    for (auto count = stream.next_chunk_size(); count > 0; count = stream.next_chunk_size()) {
+        auto const range = mapped_range<Vec>{GL_ARRAY_BUFFER, stream.position(), count};
+        stream.generate(range.span());
+    }
+}
+
+} // namespace icg::gl
+
+#endif // ICG_GL_MAPPED_RANGE_H
@@ -0,0 +1,25 @@
+#ifndef ICG_GL_MULTI_DRAW_H
+#define ICG_GL_MULTI_DRAW_H
+
+#include <icg/draw_batch.h>
+#include <tinygl/tinygl.h>
+
+namespace icg::gl {
+
+// Draws every primitive of `batch` as a `mode` primitive with one call.
+inline void multi_draw(GLenum mode, const draw_batch& batch)
+{
+    static_assert(sizeof(GLint) == sizeof(std::int32_t) && sizeof(GLsizei) == sizeof(std::int32_t));
+    if (batch.empty()) {
+        return;
+    }
+    glMultiDrawArrays(
+        mode,
+        reinterpret_cast<const GLint*>(batch.firsts().data()),
+        reinterpret_cast<const GLsizei*>(batch.counts().data()),
+        static_cast<GLsizei>(batch.size()));
+}
+
+} // namespace icg::gl
+
+#endif // ICG_GL_MULTI_DRAW_H
@@ -0,0 +1,183 @@
+#ifndef ICG_GL_OFFSCREEN_H
+#define ICG_GL_OFFSCREEN_H
+
+#include <icg/frame_writer.h>
+#include <icg/render_options.h>
+#include <tinygl/tinygl.h>
+#include <spdlog/spdlog.h>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+
+namespace icg::gl {
+
+// Framebuffer object with an RGBA8 color and a 24-bit depth renderbuffer of
+// width x height pixels.
+class offscreen_target
+{
+public:
+    offscreen_target(int width, int height)
+        : width{width}
+        , height{height}
+    {
+        glGenFramebuffers(1, &fbo);
+        glGenRenderbuffers(2, renderbuffers.data());
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            throw std::runtime_error{"Incomplete offscreen framebuffer"};
+        }
+    }
+
+    offscreen_target(const offscreen_target&) = delete;
+    offscreen_target& operator=(const offscreen_target&) = delete;
+
+    ~offscreen_target()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteRenderbuffers(2, renderbuffers.data());
+        glDeleteFramebuffers(1, &fbo);
+    }
+
+    // Binds the target for drawing and reading and covers it with the viewport.
+    void bind()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+    }
+
+private:
+    int width;
+    int height;
+    GLuint fbo{0};
+    std::array<GLuint, 2> renderbuffers{};
+};
+
+// Reads frames back through a ring of pixel-pack buffers. glReadPixels into a
+// buffer returns at once; a frame is only mapped when its buffer comes round
+// again, num_buffers frames later, just before the next read into it. By then
+// the GPU has drawn num_buffers - 1 frames since, has long finished the copy,
+// and mapping does not stall.
+class readback_ring
+{
+public:
+    static constexpr std::size_t num_buffers = 3;
+
+    readback_ring(int width, int height)
+        : width{width}
+        , height{height}
+    {
+        glGenBuffers(static_cast<GLsizei>(buffers.size()), buffers.data());
+        for (auto b : buffers) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, b);
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(frame_bytes()), nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    readback_ring(const readback_ring&) = delete;
+    readback_ring& operator=(const readback_ring&) = delete;
+
+    ~readback_ring()
+    {
+        glDeleteBuffers(static_cast<GLsizei>(buffers.size()), buffers.data());
+    }
+
+    // Starts reading the bound read framebuffer and returns the frame read
+    // num_buffers frames ago, if any.
+    std::optional<image> read()
+    {
+        auto const slot = next % buffers.size();
+        auto previous = std::optional<image>{};
+        if (next >= buffers.size()) {
+            previous = fetch(slot);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[slot]);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        ++next;
+        return previous;
+    }
+
+    // Frames still in flight, oldest first.
+    std::vector<image> drain()
+    {
+        auto frames = std::vector<image>{};
+        auto const pending = std::min(next, buffers.size());
+        for (auto k = next - pending; k < next; ++k) {
+            frames.push_back(fetch(k % buffers.size()));
+        }
+        next = 0;
+        return frames;
+    }
+
+private:
+    std::size_t frame_bytes() const
+    {
+        return sizeof(rgba8) * static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    }
+
+    image fetch(std::size_t slot)
+    {
+        auto frame = image{width, height, std::vector<rgba8>(static_cast<std::size_t>(width) * static_cast<std::size_t>(height))};
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[slot]);
+        auto const* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(frame_bytes()), GL_MAP_READ_BIT);
+        if (data == nullptr) {
+            throw std::runtime_error{"Failed to map pixel pack buffer"};
+        }
+        std::memcpy(frame.pixels.data(), data, frame_bytes());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return frame;
+    }
+
+    int width;
+    int height;
+    std::array<GLuint, num_buffers> buffers{};
+    std::size_t next{0};
+};
+
+// Renders options.frames frames of `w` into an offscreen target of the
+// requested size and writes them to options.output as <name>_<index>.ppm.
+// Readback goes through a readback_ring and encoding through a frame_writer,
+// so neither holds up drawing the next frame. process_input runs every frame
+// as well, so that replayed input drives an offscreen run.
+template <typename Window>
+void render_offscreen(Window& w, const render_options& options, const char* name)
+{
+    auto const start = std::chrono::steady_clock::now();
+    w.init();
+
+    auto target = offscreen_target{options.width, options.height};
+    auto ring = readback_ring{options.width, options.height};
+    auto writer = frame_writer{options.output, name};
+    auto written = std::size_t{0};
+    for (std::size_t frame = 0; frame < options.frames; ++frame) {
+        target.bind();
+        w.process_input();
+        w.draw();
+        if (auto read = ring.read()) {
+            writer.submit(written++, std::move(*read));
+        }
+    }
+    for (auto& read : ring.drain()) {
+        writer.submit(written++, std::move(read));
+    }
+    writer.finish();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("Rendered {} frames of {}x{} to {} in {:.3f} s ({:.1f} frames/s)",
+        written, options.width, options.height, options.output.string(), seconds, written / seconds);
+}
+
+} // namespace icg::gl
+
+#endif // ICG_GL_OFFSCREEN_H
@@ -0,0 +1,171 @@
+#ifndef ICG_GL_PROFILED_WINDOW_H
+#define ICG_GL_PROFILED_WINDOW_H
+
+#include <icg/profiler.h>
+#include <tinygl/tinygl.h>
+#include <spdlog/spdlog.h>
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace icg::gl {
+
+// GPU time of the draw commands of each frame from GL_TIME_ELAPSED queries.
+// Results are collected num_queries - 1 frames later, when they are ready, so
+// the queries never stall the pipeline. A frame whose query is still waiting
+// for the result of num_queries frames ago goes untimed instead.
+class gpu_timer
+{
+public:
+    static constexpr std::size_t num_queries = 4;
+
+    gpu_timer() { glGenQueries(static_cast<GLsizei>(queries.size()), queries.data()); }
+
+    gpu_timer(const gpu_timer&) = delete;
+    gpu_timer& operator=(const gpu_timer&) = delete;
+
+    ~gpu_timer() { glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data()); }
+
+    void begin(std::uint64_t frame)
+    {
+        auto& slot = slots[frame % num_queries];
+        timing = !slot.pending;
+        if (!timing) {
+            return;
+        }
+        slot = {frame, true};
+        glBeginQuery(GL_TIME_ELAPSED, queries[frame % num_queries]);
+    }
+
+    void end()
+    {
+        if (timing) {
+            glEndQuery(GL_TIME_ELAPSED);
+        }
+    }
+
+    // Hands every result that is ready to `p`.
+    void collect(profiler& p)
+    {
+        for (std::size_t q = 0; q < num_queries; ++q) {
+            if (!slots[q].pending) {
+                continue;
+            }
+            auto available = GLint{0};
+            glGetQueryObjectiv(queries[q], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == GL_FALSE) {
+                continue;
+            }
+            auto nanoseconds = GLuint64{0};
+            glGetQueryObjectui64v(queries[q], GL_QUERY_RESULT, &nanoseconds);
+            p.record_gpu(slots[q].frame, static_cast<float>(nanoseconds) * 1e-6f);
+            slots[q].pending = false;
+        }
+    }
+
+private:
+    struct slot
+    {
+        std::uint64_t frame{0};
+        bool pending{false};
+    };
+
+    std::array<GLuint, num_queries> queries{};
+    std::array<slot, num_queries> slots{};
+    // whether the current frame got a query
+    bool timing{false};
+};
+
+// Demo window with its process_input, draw and draw_ui timed on the CPU and
+// its draw on the GPU. The frame time percentiles of the last frames are shown
+// in a window of their own, and if `trace` is not empty every kept frame is
+// written to it on exit, as a Chrome trace (.json) or as CSV.
+template <typename Window>
+class profiled_window final : public Window
+{
+public:
+    template <typename... Args>
+    explicit profiled_window(std::filesystem::path trace, Args&&... args)
+        : Window(std::forward<Args>(args)...)
+        , trace{std::move(trace)}
+    {
+    }
+
+    ~profiled_window() override
+    {
+        if (trace.empty()) {
+            return;
+        }
+        try {
+            frames.write(trace);
+            spdlog::info("Wrote frame timings to {}", trace.string());
+        } catch (const std::exception& e) {
+            spdlog::error("{}", e.what());
+        }
+    }
+
+    void init() override
+    {
+        Window::init();
+        timer.emplace();
+    }
+
+    void process_input() override
+    {
+        auto const phase = scoped_phase{frames, frame_phase::process_input};
+        Window::process_input();
+    }
+
+    void draw() override
+    {
+        {
+            auto const phase = scoped_phase{frames, frame_phase::draw};
+            timer->begin(frames.current_frame());
+            Window::draw();
+            timer->end();
+        }
+        timer->collect(frames);
+    }
+
+    void draw_ui() override
+    {
+        auto const phase = scoped_phase{frames, frame_phase::draw_ui};
+        Window::draw_ui();
+        draw_overlay();
+    }
+
+private:
+    static constexpr std::size_t overlay_frames = 240;
+
+    void draw_overlay()
+    {
+        auto const samples = frames.latest(overlay_frames);
+        auto cpu = std::vector<float>{};
+        auto gpu = std::vector<float>{};
+        for (auto const& s : samples) {
+            cpu.push_back(s.cpu_ms());
+            if (auto const ms = s.duration_ms[static_cast<std::size_t>(frame_phase::gpu)]; ms >= 0.0f) {
+                gpu.push_back(ms);
+            }
+        }
+
+        ImGui::Begin("Frame time", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+        ImGui::PlotLines("CPU ms", cpu.data(), static_cast<int>(cpu.size()));
+        auto const c = compute_percentiles(cpu);
+        ImGui::Text("CPU p50 %.2f ms, p95 %.2f ms, p99 %.2f ms", c.p50, c.p95, c.p99);
+        auto const g = compute_percentiles(gpu);
+        ImGui::Text("GPU p50 %.2f ms, p95 %.2f ms, p99 %.2f ms", g.p50, g.p95, g.p99);
+        ImGui::End();
+    }
+
+    std::filesystem::path trace;
+    profiler frames;
+    // created once the GL context exists
+    std::optional<gpu_timer> timer;
+};
+
+} // namespace icg::gl
+
+#endif // ICG_GL_PROFILED_WINDOW_H
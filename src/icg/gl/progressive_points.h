@@ -0,0 +1,81 @@
+#ifndef ICG_GL_PROGRESSIVE_POINTS_H
+#define ICG_GL_PROGRESSIVE_POINTS_H
+
+#include <icg/frame_clock.h>
+#include <icg/gl/mapped_range.h>
+#include <icg/memory.h>
+#include <icg/progressive_chaos_game.h>
+#include <tinygl/tinygl.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+namespace icg::gl {
+
+// Upload time per frame a progressive_points spends at most, after the first
+// chunk that is ready.
+constexpr auto progressive_upload_budget = std::chrono::milliseconds{4};
+
+// Point cloud of a progressive_chaos_game uploaded into `buffer` as its chunks
+// become ready, so that the first frame comes right away and every frame
+// draws the points generated so far. Logs the time to the first frame with
+// points and the fill rate once all of them are in. Runs with a fixed time
+// step are meant to be reproducible frame for frame, so there the first
+// update waits for all points instead.
+template <typename Vec, std::size_t N>
+class progressive_points
+{
+public:
+    // Allocates `buffer` for all points and starts generating them.
+    progressive_points(tinygl::buffer& buffer, const std::array<Vec, N>& vertices, std::size_t num_positions, std::uint32_t seed)
+        : buffer{buffer}
+        , generator{vertices, num_positions, seed}
+    {
+        buffer.bind();
+        buffer.create(sizeof(Vec) * num_positions);
+    }
+
+    // Uploads the chunks that are ready, within progressive_upload_budget, and
+    // returns the number of points that can be drawn.
+    std::size_t update()
+    {
+        if (generator.done()) {
+            return generator.size();
+        }
+        buffer.bind();
+        auto const upload = [](std::size_t first, std::span<const Vec> points) {
+            auto const range = mapped_range<Vec>{GL_ARRAY_BUFFER, first, points.size()};
+            std::ranges::copy(points, range.span().begin());
+        };
+        generator.consume(progressive_upload_budget, upload);
+        while (wait_for_all && !generator.done()) {
+            std::this_thread::sleep_for(std::chrono::microseconds{100});
+            generator.consume(std::chrono::steady_clock::duration::max(), upload);
+        }
+
+        auto const& stats = generator.stats();
+        if (!reported_first && stats.points > 0) {
+            spdlog::info("First frame with {} points after {:.1f} ms", stats.points, 1e3 * stats.first_chunk_seconds);
+            reported_first = true;
+        }
+        if (generator.done()) {
+            spdlog::info("Generated {} points in {:.3f} s ({:.0f} points/s), peak resident memory: {} KiB",
+                stats.points, stats.seconds, stats.fill_rate(), peak_resident_bytes() / 1024);
+        }
+        return generator.consumed_size();
+    }
+
+    const progressive_stats& stats() const { return generator.stats(); }
+
+private:
+    tinygl::buffer& buffer;
+    progressive_chaos_game<Vec, N> generator;
+    bool wait_for_all{default_fixed_step() > 0.0};
+    bool reported_first{false};
+};
+
+} // namespace icg::gl
+
+#endif // ICG_GL_PROGRESSIVE_POINTS_H
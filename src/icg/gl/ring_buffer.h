@@ -0,0 +1,112 @@
+#ifndef ICG_GL_RING_BUFFER_H
+#define ICG_GL_RING_BUFFER_H
+
+#include <icg/gl/mapped_range.h>
+#include <tinygl/tinygl.h>
+#include <cstddef>
+#include <vector>
+
+namespace icg::gl {
+
+// Counts of the frames written through a ring_buffer and of those that had
+// to wait for the GPU to finish reading their region.
+struct ring_stats
+{
+    std::size_t frames{0};
+    std::size_t stalls{0};
+};
+
+// Vertex buffer of `num_regions` regions of `count` Ts written by the CPU
+// once per frame, one region after the other. A fence after the draws of a
+// frame guards its region, so with two or three regions the CPU fills the
+// next one unsynchronized while the GPU still reads the previous ones and
+// only waits if it gets that many frames ahead. With one region the driver
+// synchronizes the mapping itself.
+template <typename T>
+class ring_buffer
+{
+public:
+    ring_buffer(tinygl::buffer& buffer, std::size_t count, std::size_t num_regions)
+        : buffer{buffer}
+        , count{count}
+        , fences(num_regions, nullptr)
+    {
+    }
+
+    ring_buffer(const ring_buffer&) = delete;
+    ring_buffer& operator=(const ring_buffer&) = delete;
+
+    ~ring_buffer()
+    {
+        for (auto fence : fences) {
+            glDeleteSync(fence);
+        }
+    }
+
+    std::size_t size() const { return count; }
+    std::size_t num_regions() const { return fences.size(); }
+
+    // Allocates the GPU storage, to be called once the GL context exists.
+    void create()
+    {
+        buffer.bind();
+        buffer.create(sizeof(T) * count * fences.size());
+    }
+
+    // Maps the region of the next frame, once the GPU is done with the frame
+    // drawn from it num_regions() frames ago.
+    mapped_range<T> map_next()
+    {
+        current = (current + 1) % fences.size();
+        ++counts.frames;
+        auto access = GLbitfield{GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT};
+        if (fences.size() > 1) {
+            wait(fences[current]);
+            access |= GL_MAP_UNSYNCHRONIZED_BIT;
+        }
+        buffer.bind();
+        return mapped_range<T>{GL_ARRAY_BUFFER, first(), count, access};
+    }
+
+    // First element of the region mapped last.
+    std::size_t first() const { return current * count; }
+
+    // Guards the region mapped last until the commands issued so far, the
+    // draws reading it among them, have completed.
+    void fence()
+    {
+        if (fences.size() > 1) {
+            glDeleteSync(fences[current]);
+            fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+
+    const ring_stats& stats() const { return counts; }
+
+private:
+    void wait(GLsync& fence)
+    {
+        if (fence == nullptr) {
+            return;
+        }
+        auto status = glClientWaitSync(fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            ++counts.stalls;
+            while (status == GL_TIMEOUT_EXPIRED) {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000);
+            }
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    tinygl::buffer& buffer;
+    std::size_t count;
+    std::vector<GLsync> fences;
+    std::size_t current{0};
+    ring_stats counts;
+};
+
+} // namespace icg::gl
+
+#endif // ICG_GL_RING_BUFFER_H
@@ -0,0 +1,353 @@
+#ifndef ICG_GL_SHADER_PROGRAM_H
+#define ICG_GL_SHADER_PROGRAM_H
+
+#include <icg/program_cache.h>
+#include <icg/shader_source.h>
+#include <icg/transform.h>
+#include <icg/uniform_shadow.h>
+#include <icg/vector.h>
+#include <tinygl/tinygl.h>
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace icg::gl {
+
+// Shader program with the interface of tinygl::shader_program whose link
+// goes through the program_cache: the linked binary of the same sources on
+// the same driver is loaded with glProgramBinary instead of compiling GLSL,
+// and a program linked from source is stored for the next start. Without
+// binary formats, or when the driver refuses a cached binary, it compiles
+// from source as tinygl does. Every link logs whether it was a cache hit and
+// how long it took.
+//
+// Shaders come from sources embedded at build time, or from files, which go
+// through the same preprocessing as embedded ones.
+//
+// After linking, the active uniforms are introspected and every value set is
+// kept in a uniform_shadow, so setting a uniform to the value it has already
+// is not passed on to the driver. As with tinygl, values go to the program in
+// use.
+class shader_program
+{
+public:
+    shader_program() = default;
+
+    shader_program(const shader_program&) = delete;
+    shader_program& operator=(const shader_program&) = delete;
+
+    ~shader_program()
+    {
+        if (program != 0) {
+            glDeleteProgram(program);
+        }
+    }
+
+    void add_shader_from_source_file(tinygl::shader::type type, const std::filesystem::path& path)
+    {
+        shaders.push_back({type, preprocess_shader_file(path), path.filename().string()});
+    }
+
+    // Adds an embedded shader without any file I/O, unless a shader directory
+    // is set (see set_default_shader_directory), in which case the file of
+    // the same name is read from there instead.
+    void add_shader_from_source(tinygl::shader::type type, const shader_source& source)
+    {
+        if (auto const& directory = default_shader_directory(); !directory.empty()) {
+            add_shader_from_source_file(type, directory / source.name);
+            return;
+        }
+        shaders.push_back({type, std::string{source.text}, std::string{source.name}});
+    }
+
+    // Outputs of the vertex shader that transform feedback captures, each into
+    // a buffer of its own if `separate`. Takes effect at the next link.
+    void set_transform_feedback_varyings(std::vector<std::string> names, bool separate = false)
+    {
+        varyings = std::move(names);
+        separate_varyings = separate;
+    }
+
+    void link()
+    {
+        auto const start = std::chrono::steady_clock::now();
+        auto& cache = default_program_cache();
+        auto const key = cache_key();
+        if (program != 0) {
+            glDeleteProgram(program);
+        }
+        program = glCreateProgram();
+
+        // program binaries need GL 4.1 or ARB_get_program_binary, which a 3.3
+        // context may lack, entry points included
+        auto const binaries = binary_formats_supported();
+        auto hit = false;
+        if (binaries) {
+            if (auto const binary = cache.load(key)) {
+                hit = link_binary(*binary);
+                if (!hit) {
+                    cache.reject();
+                    glDeleteProgram(program);
+                    program = glCreateProgram();
+                }
+            }
+        }
+        if (!hit) {
+            link_source(binaries);
+            if (binaries) {
+                cache.store(key, get_binary());
+            }
+        }
+
+        introspect_uniforms();
+        load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        cache_hit = hit;
+        spdlog::info("Program {}: cache {} in {:.2f} ms", name(), hit ? "hit" : "miss", load_ms);
+    }
+
+    void use() { glUseProgram(program); }
+
+    GLuint id() const { return program; }
+
+    GLint attribute_location(const std::string& name) const { return glGetAttribLocation(program, name.c_str()); }
+    GLint uniform_location(const std::string& name) const { return glGetUniformLocation(program, name.c_str()); }
+
+    void set_uniform_value(GLint location, float value)
+    {
+        if (uniforms.update(location, value)) {
+            glUniform1f(location, value);
+        }
+    }
+
+    void set_uniform_value(GLint location, int value)
+    {
+        if (uniforms.update(location, value)) {
+            glUniform1i(location, value);
+        }
+    }
+
+    void set_uniform_value(GLint location, unsigned value)
+    {
+        if (uniforms.update(location, value)) {
+            glUniform1ui(location, value);
+        }
+    }
+
+    void set_uniform_value(GLint location, const vec2& value)
+    {
+        if (uniforms.update(location, value)) {
+            glUniform2f(location, value.x, value.y);
+        }
+    }
+
+    void set_uniform_value(GLint location, const vec3& value)
+    {
+        if (uniforms.update(location, value)) {
+            glUniform3f(location, value.x, value.y, value.z);
+        }
+    }
+
+    void set_uniform_value(GLint location, const vec4& value)
+    {
+        if (uniforms.update(location, value)) {
+            glUniform4f(location, value.x, value.y, value.z, value.w);
+        }
+    }
+
+    void set_uniform_value(GLint location, const mat4& value)
+    {
+        if (uniforms.update(location, value)) {
+            glUniformMatrix4fv(location, 1, GL_FALSE, value.data());
+        }
+    }
+
+    // Sources uniform block `name` from the uniform buffer bound to `binding`
+    // (see uniform_buffer), which programs sharing the block all read.
+    void bind_uniform_block(const std::string& name, GLuint binding)
+    {
+        auto const index = glGetUniformBlockIndex(program, name.c_str());
+        if (index == GL_INVALID_INDEX) {
+            throw std::runtime_error{"No uniform block " + name + " in " + this->name()};
+        }
+        glUniformBlockBinding(program, index, binding);
+    }
+
+    // Number of active uniforms outside of blocks, and the uploads of their
+    // values issued and skipped.
+    std::size_t num_uniforms() const { return uniforms.size(); }
+    const icg::uniform_stats& uniform_upload_stats() const { return uniforms.stats(); }
+
+    // Whether the last link loaded a cached binary, and how long it took.
+    bool was_cache_hit() const { return cache_hit; }
+    double link_ms() const { return load_ms; }
+
+private:
+    struct shader
+    {
+        tinygl::shader::type type;
+        std::string source;
+        std::string name;
+    };
+
+    // Bytes of a value of the uniform type `type`.
+    static std::size_t uniform_size(GLenum type)
+    {
+        switch (type) {
+        case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_BOOL_VEC2: return 8;
+        case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_BOOL_VEC3: return 12;
+        case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_BOOL_VEC4: case GL_FLOAT_MAT2: return 16;
+        case GL_FLOAT_MAT3: return 36;
+        case GL_FLOAT_MAT4: return 64;
+        default: return 4; // scalars and samplers
+        }
+    }
+
+    void introspect_uniforms()
+    {
+        uniforms.clear();
+        auto count = GLint{0};
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+        auto max_length = GLint{0};
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+        auto name = std::string(static_cast<std::size_t>(max_length), '\0');
+        for (GLuint i = 0; i < static_cast<GLuint>(count); ++i) {
+            auto length = GLsizei{0};
+            auto size = GLint{0};
+            auto type = GLenum{0};
+            glGetActiveUniform(program, i, max_length, &length, &size, &type, name.data());
+            // -1 for uniforms in blocks, whose values live in buffers
+            auto const location = glGetUniformLocation(program, name.c_str());
+            uniforms.declare(location, uniform_size(type));
+        }
+    }
+
+    static bool binary_formats_supported()
+    {
+        auto formats = GLint{0};
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }
+
+    static std::string gl_string(GLenum name)
+    {
+        auto const s = glGetString(name);
+        return s != nullptr ? reinterpret_cast<const char*>(s) : "";
+    }
+
+    std::uint64_t cache_key() const
+    {
+        auto const driver = gl_string(GL_VENDOR) + '\n' + gl_string(GL_RENDERER) + '\n' + gl_string(GL_VERSION);
+        auto sources = std::vector<std::string_view>{};
+        // the same text compiled as a different stage is a different program
+        auto stages = std::string{"stages"};
+        for (auto const& s : shaders) {
+            sources.push_back(s.source);
+            stages += ' ' + std::to_string(static_cast<int>(s.type));
+        }
+        sources.push_back(stages);
+        // the varyings are part of what is linked
+        auto captured = std::string{separate_varyings ? "separate" : "interleaved"};
+        for (auto const& v : varyings) {
+            captured += ' ' + v;
+        }
+        sources.push_back(captured);
+        return program_cache_key(sources, driver);
+    }
+
+    std::string name() const
+    {
+        auto joined = std::string{};
+        for (auto const& s : shaders) {
+            joined += (joined.empty() ? "" : "+") + s.name;
+        }
+        return joined;
+    }
+
+    bool link_binary(const program_binary& binary)
+    {
+        glProgramBinary(program, binary.format, binary.data.data(), static_cast<GLsizei>(binary.data.size()));
+        auto linked = GLint{GL_FALSE};
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        return linked == GL_TRUE;
+    }
+
+    void link_source(bool retrievable)
+    {
+        auto compiled = std::vector<GLuint>{};
+        for (auto const& s : shaders) {
+            auto const object = glCreateShader(s.type == tinygl::shader::type::vertex ? GL_VERTEX_SHADER : GL_FRAGMENT_SHADER);
+            auto const text = s.source.c_str();
+            glShaderSource(object, 1, &text, nullptr);
+            glCompileShader(object);
+            auto ok = GLint{GL_FALSE};
+            glGetShaderiv(object, GL_COMPILE_STATUS, &ok);
+            if (ok != GL_TRUE) {
+                auto const log = info_log(object, glGetShaderiv, glGetShaderInfoLog);
+                glDeleteShader(object);
+                throw std::runtime_error{"Failed to compile " + s.name + ":\n" + log};
+            }
+            glAttachShader(program, object);
+            compiled.push_back(object);
+        }
+
+        if (!varyings.empty()) {
+            auto names = std::vector<const char*>{};
+            for (auto const& v : varyings) {
+                names.push_back(v.c_str());
+            }
+            glTransformFeedbackVaryings(program, static_cast<GLsizei>(names.size()), names.data(),
+                separate_varyings ? GL_SEPARATE_ATTRIBS : GL_INTERLEAVED_ATTRIBS);
+        }
+        if (retrievable) {
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        glLinkProgram(program);
+        for (auto const object : compiled) {
+            glDetachShader(program, object);
+            glDeleteShader(object);
+        }
+        auto ok = GLint{GL_FALSE};
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        if (ok != GL_TRUE) {
+            throw std::runtime_error{"Failed to link " + name() + ":\n" + info_log(program, glGetProgramiv, glGetProgramInfoLog)};
+        }
+    }
+
+    program_binary get_binary() const
+    {
+        auto length = GLint{0};
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        auto binary = program_binary{0, std::vector<std::byte>(static_cast<std::size_t>(length))};
+        auto format = GLenum{0};
+        glGetProgramBinary(program, length, nullptr, &format, binary.data.data());
+        binary.format = format;
+        return binary;
+    }
+
+    template <typename Get, typename Log>
+    static std::string info_log(GLuint object, Get get, Log log)
+    {
+        auto length = GLint{0};
+        get(object, GL_INFO_LOG_LENGTH, &length);
+        auto text = std::string(static_cast<std::size_t>(length), '\0');
+        log(object, length, nullptr, text.data());
+        return text;
+    }
+
+    std::vector<shader> shaders;
+    std::vector<std::string> varyings;
+    bool separate_varyings{false};
+    GLuint program{0};
+    icg::uniform_shadow uniforms;
+    bool cache_hit{false};
+    double load_ms{0.0};
+};
+
+} // namespace icg::gl
+
+#endif // ICG_GL_SHADER_PROGRAM_H
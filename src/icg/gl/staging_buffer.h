@@ -0,0 +1,156 @@
+#ifndef ICG_GL_STAGING_BUFFER_H
+#define ICG_GL_STAGING_BUFFER_H
+
+#include <icg/growable_storage.h>
+#include <tinygl/tinygl.h>
+#include <cstddef>
+#include <span>
+
+namespace icg::gl {
+
+// Counts of the edits recorded into a staging_buffer and of the buffer
+// updates actually issued for them.
+struct staging_stats
+{
+    std::size_t edits{0};
+    std::size_t updates{0};
+
+    std::size_t coalesced() const { return edits - updates; }
+};
+
+// Vertex buffer of Ts with a CPU copy that grows without bound. Edits only
+// touch the copy and mark their elements dirty; flush, called once per frame
+// before drawing, first grows the GPU storage if the copy outgrew it and then
+// uploads each merged dirty range with a single update however many edits
+// went into it.
+template <typename T>
+class staging_buffer
+{
+public:
+    explicit staging_buffer(tinygl::buffer& buffer, std::size_t initial_capacity = 0)
+        : buffer{buffer}
+        , shadow{initial_capacity}
+    {
+    }
+
+    // Elements [0, size()) to draw.
+    std::size_t size() const { return shadow.size(); }
+    std::size_t capacity() const { return shadow.capacity(); }
+    const growable_storage<T>& storage() const { return shadow; }
+
+    // Allocates the GPU storage, to be called once the GL context exists.
+    void create()
+    {
+        buffer.bind();
+        buffer.create(sizeof(T) * shadow.capacity());
+        allocated = shadow.capacity();
+    }
+
+    std::size_t append(std::span<const T> values)
+    {
+        ++frame.edits;
+        return shadow.append(values);
+    }
+
+    std::size_t append(const T& value)
+    {
+        return append(std::span<const T>{&value, 1});
+    }
+
+    // Stores `values` in a released block if there is one large enough.
+    std::size_t store(std::span<const T> values)
+    {
+        ++frame.edits;
+        return shadow.store(values);
+    }
+
+    void set(std::size_t first, std::span<const T> values)
+    {
+        shadow.set(first, values);
+        ++frame.edits;
+    }
+
+    void set(std::size_t index, const T& value)
+    {
+        set(index, std::span<const T>{&value, 1});
+    }
+
+    void release(std::size_t first, std::size_t count)
+    {
+        shadow.release(first, count);
+        ++frame.edits;
+    }
+
+    void flush()
+    {
+        if (allocated < shadow.capacity()) {
+            grow();
+        }
+        if (!shadow.dirty_ranges().empty()) {
+            buffer.bind();
+            auto const data = shadow.data();
+            for (auto const& range : shadow.dirty_ranges()) {
+                auto const first = data.begin() + static_cast<std::ptrdiff_t>(range.first);
+                buffer.update(sizeof(T) * range.first, first, first + static_cast<std::ptrdiff_t>(range.size()));
+                ++frame.updates;
+            }
+            shadow.clear_dirty();
+        }
+        uploaded = shadow.size();
+        last_frame = frame;
+        total.edits += frame.edits;
+        total.updates += frame.updates;
+        frame = {};
+    }
+
+    // Counts of the last flushed frame and of all frames so far.
+    const staging_stats& last_frame_stats() const { return last_frame; }
+    const staging_stats& total_stats() const { return total; }
+
+private:
+    // Reallocates the buffer at the capacity of the CPU copy. The elements
+    // uploaded so far are copied over on the GPU, through a scratch buffer so
+    // that `buffer` keeps its name and the vertex array bound to it stays
+    // valid; the dirty ranges are uploaded afterwards as usual.
+    void grow()
+    {
+        auto const bytes = static_cast<GLsizeiptr>(sizeof(T) * uploaded);
+        buffer.bind();
+        if (bytes == 0) {
+            buffer.create(sizeof(T) * shadow.capacity());
+            allocated = shadow.capacity();
+            return;
+        }
+
+        auto name = GLint{0};
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &name);
+        auto scratch = GLuint{0};
+        glGenBuffers(1, &scratch);
+        glBindBuffer(GL_COPY_READ_BUFFER, static_cast<GLuint>(name));
+        glBindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+        glBufferData(GL_COPY_WRITE_BUFFER, bytes, nullptr, GL_STREAM_COPY);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, bytes);
+
+        buffer.create(sizeof(T) * shadow.capacity());
+
+        glBindBuffer(GL_COPY_READ_BUFFER, scratch);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, static_cast<GLuint>(name));
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, bytes);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glDeleteBuffers(1, &scratch);
+        allocated = shadow.capacity();
+    }
+
+    tinygl::buffer& buffer;
+    growable_storage<T> shadow;
+    std::size_t allocated{0};
+    std::size_t uploaded{0};
+    staging_stats frame;
+    staging_stats last_frame;
+    staging_stats total;
+};
+
+} // namespace icg::gl
+
+#endif // ICG_GL_STAGING_BUFFER_H
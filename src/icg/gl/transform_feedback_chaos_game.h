@@ -0,0 +1,144 @@
+#ifndef ICG_GL_TRANSFORM_FEEDBACK_CHAOS_GAME_H
+#define ICG_GL_TRANSFORM_FEEDBACK_CHAOS_GAME_H
+
+#include <icg/chaos_game_chains.h>
+#include <icg/gl/shader_program.h>
+#include <tinygl/tinygl.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace icg::gl {
+
+// Chaos game generated on the GPU: `num_chains` chains advance in parallel in
+// the vertex shader chaos_game.vert, one vertex per chain, and transform
+// feedback captures every step straight into the vertex buffer that is then
+// drawn, so the points never cross the bus. The state of the chains ping-pongs
+// between two buffers, each with a vertex array reading it: a step reads one
+// and captures into the other, so nothing is copied between steps. The layout
+// and the bits of the output are those of icg::chaos_game_chains, its CPU
+// reference.
+//
+// `program` must hold chaos_game.vert with vPosition and vState captured into
+// separate buffers (see set_transform_feedback_varyings) and be linked.
+class transform_feedback_chaos_game
+{
+public:
+    transform_feedback_chaos_game(shader_program& program, const std::array<vec3, 4>& vertices, std::size_t num_chains, std::uint32_t seed)
+        : program{program}
+        , num_chains{num_chains}
+    {
+        glGenVertexArrays(2, vaos.data());
+        glGenBuffers(2, states.data());
+        glGenBuffers(1, &keys);
+
+        auto const start = std::vector<vec3>(num_chains, chaos_game_chain_start(vertices));
+        auto const chain_keys = chaos_game_chain_keys(seed, num_chains);
+        glBindBuffer(GL_ARRAY_BUFFER, keys);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(std::uint32_t) * num_chains), chain_keys.data(), GL_STATIC_DRAW);
+        auto const state_loc = static_cast<GLuint>(program.attribute_location("aState"));
+        auto const key_loc = static_cast<GLuint>(program.attribute_location("aKey"));
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            glBindVertexArray(vaos[i]);
+            glBindBuffer(GL_ARRAY_BUFFER, states[i]);
+            // the chains start from the first buffer, the second is written first
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(vec3) * num_chains), i == 0 ? start.data() : nullptr, GL_DYNAMIC_COPY);
+            glVertexAttribPointer(state_loc, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+            glEnableVertexAttribArray(state_loc);
+            glBindBuffer(GL_ARRAY_BUFFER, keys);
+            glVertexAttribIPointer(key_loc, 1, GL_UNSIGNED_INT, 0, nullptr);
+            glEnableVertexAttribArray(key_loc);
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        program.use();
+        auto components = std::array<float, 3 * 4>{};
+        for (std::size_t j = 0; j < vertices.size(); ++j) {
+            components[3 * j] = vertices[j].x;
+            components[3 * j + 1] = vertices[j].y;
+            components[3 * j + 2] = vertices[j].z;
+        }
+        glUniform3fv(program.uniform_location("uVertices"), 4, components.data());
+        glUniform1ui(program.uniform_location("uCount"), static_cast<GLuint>(vertices.size()));
+        counter_loc = program.uniform_location("uCounter");
+        steps_loc = program.uniform_location("uSteps");
+    }
+
+    transform_feedback_chaos_game(const transform_feedback_chaos_game&) = delete;
+    transform_feedback_chaos_game& operator=(const transform_feedback_chaos_game&) = delete;
+
+    ~transform_feedback_chaos_game()
+    {
+        glDeleteBuffers(1, &keys);
+        glDeleteBuffers(2, states.data());
+        glDeleteVertexArrays(2, vaos.data());
+    }
+
+    // Allocates `buffer` for `steps` points of every chain and generates them
+    // into it with one transform feedback pass per step. The chains carry on
+    // where the previous call left them.
+    void generate(tinygl::buffer& buffer, std::size_t steps)
+    {
+        auto const bytes = static_cast<GLsizeiptr>(sizeof(vec3) * num_chains);
+        buffer.bind();
+        buffer.create(sizeof(vec3) * num_chains * steps);
+        auto name = GLint{0};
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &name);
+        auto const output = static_cast<GLuint>(name);
+
+        program.use();
+        glEnable(GL_RASTERIZER_DISCARD);
+        for (std::size_t s = 0; s < steps; ++s) {
+            // the first step runs the burn-in as well
+            auto const first = next == 0;
+            program.set_uniform_value(counter_loc, first ? 0u : chaos_game_burn_in + next);
+            program.set_uniform_value(steps_loc, first ? chaos_game_burn_in + 1 : 1u);
+
+            // the points go to their step of the output, and the state of the
+            // chains to the buffer the next step reads
+            glBindVertexArray(vaos[current]);
+            glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, output, bytes * static_cast<GLintptr>(s), bytes);
+            glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 1, states[1 - current]);
+            glBeginTransformFeedback(GL_POINTS);
+            glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(num_chains));
+            glEndTransformFeedback();
+            current = 1 - current;
+            ++next;
+        }
+        glDisable(GL_RASTERIZER_DISCARD);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 1, 0);
+        glBindVertexArray(0);
+    }
+
+    // Reads back the points of the last generate, e.g. to check them against
+    // chaos_game_chains.
+    static std::vector<vec3> read(tinygl::buffer& buffer, std::size_t count)
+    {
+        auto points = std::vector<vec3>(count);
+        buffer.bind();
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(sizeof(vec3) * count), points.data());
+        return points;
+    }
+
+    std::size_t size() const { return num_chains; }
+
+private:
+    shader_program& program;
+    std::size_t num_chains;
+    std::uint32_t next{0};
+    // the state buffer the next step reads, through the vertex array of the same index
+    std::size_t current{0};
+    std::array<GLuint, 2> vaos{};
+    std::array<GLuint, 2> states{};
+    GLuint keys{0};
+    GLint counter_loc{-1};
+    GLint steps_loc{-1};
+};
+
+} // namespace icg::gl
+
+#endif // ICG_GL_TRANSFORM_FEEDBACK_CHAOS_GAME_H
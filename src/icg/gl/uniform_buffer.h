@@ -0,0 +1,63 @@
+#ifndef ICG_GL_UNIFORM_BUFFER_H
+#define ICG_GL_UNIFORM_BUFFER_H
+
+#include <icg/uniform_shadow.h>
+#include <tinygl/tinygl.h>
+#include <cstring>
+#include <type_traits>
+
+namespace icg::gl {
+
+// Uniform buffer object holding one `Block`, a struct laid out as the std140
+// uniform block it backs, bound to `binding` for every program that sources
+// the block from there (see shader_program::bind_uniform_block). Uniforms
+// many programs share are then uploaded once per change rather than once per
+// program, and like shader_program it skips uploads of unchanged values.
+template <typename Block>
+class uniform_buffer
+{
+public:
+    static_assert(std::is_trivially_copyable_v<Block>);
+
+    explicit uniform_buffer(GLuint binding)
+        : binding{binding}
+    {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+    }
+
+    uniform_buffer(const uniform_buffer&) = delete;
+    uniform_buffer& operator=(const uniform_buffer&) = delete;
+
+    ~uniform_buffer() { glDeleteBuffers(1, &buffer); }
+
+    void set(const Block& block)
+    {
+        if (known && std::memcmp(&value, &block, sizeof(Block)) == 0) {
+            ++counts.skipped;
+            return;
+        }
+        value = block;
+        known = true;
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &value);
+        ++counts.issued;
+    }
+
+    const Block& get() const { return value; }
+    GLuint binding_point() const { return binding; }
+    const uniform_stats& stats() const { return counts; }
+
+private:
+    GLuint binding;
+    GLuint buffer{0};
+    Block value{};
+    bool known{false};
+    uniform_stats counts;
+};
+
+} // namespace icg::gl
+
+#endif // ICG_GL_UNIFORM_BUFFER_H
@@ -0,0 +1,142 @@
+#ifndef ICG_GL_VERTEX_LAYOUT_H
+#define ICG_GL_VERTEX_LAYOUT_H
+
+#include <icg/color.h>
+#include <icg/gl/shader_program.h>
+#include <icg/vector.h>
+#include <tinygl/tinygl.h>
+#include <array>
+#include <cstddef>
+
+namespace icg::gl {
+
+// How OpenGL reads one member type of a vertex struct.
+template <typename T>
+struct attribute_format;
+
+template <>
+struct attribute_format<float>
+{
+    static constexpr int size = 1;
+    static constexpr GLenum type = GL_FLOAT;
+    static constexpr GLboolean normalized = GL_FALSE;
+};
+
+template <>
+struct attribute_format<vec2>
+{
+    static constexpr int size = 2;
+    static constexpr GLenum type = GL_FLOAT;
+    static constexpr GLboolean normalized = GL_FALSE;
+};
+
+template <>
+struct attribute_format<vec3>
+{
+    static constexpr int size = 3;
+    static constexpr GLenum type = GL_FLOAT;
+    static constexpr GLboolean normalized = GL_FALSE;
+};
+
+template <>
+struct attribute_format<vec4>
+{
+    static constexpr int size = 4;
+    static constexpr GLenum type = GL_FLOAT;
+    static constexpr GLboolean normalized = GL_FALSE;
+};
+
+template <>
+struct attribute_format<rgba8>
+{
+    static constexpr int size = 4;
+    static constexpr GLenum type = GL_UNSIGNED_BYTE;
+    static constexpr GLboolean normalized = GL_TRUE;
+};
+
+// One attribute of an interleaved vertex: the shader input it feeds and where
+// it sits in the vertex.
+struct vertex_attribute
+{
+    const char* name;
+    int size;
+    GLenum type;
+    GLboolean normalized;
+    std::size_t offset;
+};
+
+// Attribute of member type T at `offset` (use offsetof) in the vertex.
+template <typename T>
+constexpr vertex_attribute attribute(const char* name, std::size_t offset)
+{
+    return {name, attribute_format<T>::size, attribute_format<T>::type, attribute_format<T>::normalized, offset};
+}
+
+// Specialize for a vertex struct with a constexpr `attributes` array, e.g.
+//
+//     template <>
+//     struct icg::gl::vertex_layout<my_vertex>
+//     {
+//         static constexpr std::array attributes = {
+//             icg::gl::attribute<icg::vec3>("aPosition", offsetof(my_vertex, position)),
+//             icg::gl::attribute<icg::rgba8>("aColor", offsetof(my_vertex, color))
+//         };
+//     };
+template <typename Vertex>
+struct vertex_layout;
+
+// Vertices of the demos: a position and a packed color, 12 and 16 bytes.
+
+struct colored_vertex2
+{
+    vec2 position;
+    rgba8 color;
+};
+
+struct colored_vertex3
+{
+    vec3 position;
+    rgba8 color;
+};
+
+static_assert(sizeof(colored_vertex2) == 12);
+static_assert(sizeof(colored_vertex3) == 16);
+
+template <>
+struct vertex_layout<colored_vertex2>
+{
+    static constexpr std::array attributes = {
+        attribute<vec2>("aPosition", offsetof(colored_vertex2, position)),
+        attribute<rgba8>("aColor", offsetof(colored_vertex2, color))
+    };
+};
+
+template <>
+struct vertex_layout<colored_vertex3>
+{
+    static constexpr std::array attributes = {
+        attribute<vec3>("aPosition", offsetof(colored_vertex3, position)),
+        attribute<rgba8>("aColor", offsetof(colored_vertex3, color))
+    };
+};
+
+// Points the attributes of `vao` at the interleaved `Vertex`s of the buffer
+// currently bound to GL_ARRAY_BUFFER. Attributes `program` does not use are
+// skipped.
+template <typename Vertex>
+void set_vertex_layout(tinygl::vertex_array_object& vao, shader_program& program)
+{
+    vao.bind();
+    for (auto const& a : vertex_layout<Vertex>::attributes) {
+        auto const loc = program.attribute_location(a.name);
+        if (static_cast<GLint>(loc) < 0) {
+            continue;
+        }
+        vao.set_attribute_array(loc, a.size, a.type, a.normalized, sizeof(Vertex), a.offset);
+        vao.enable_attribute_array(loc);
+    }
+}
+
+} // namespace icg::gl
+
+#endif // ICG_GL_VERTEX_LAYOUT_H
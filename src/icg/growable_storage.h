@@ -0,0 +1,139 @@
+#ifndef ICG_GROWABLE_STORAGE_H
+#define ICG_GROWABLE_STORAGE_H
+
+#include <icg/dirty_ranges.h>
+#include <icg/free_list.h>
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace icg {
+
+// Smallest capacity a storage starts out with once something is stored.
+constexpr std::size_t min_growable_capacity = 64;
+
+// Capacity of a storage of `capacity` elements grown to hold `required` ones.
+// Doubling keeps the elements copied by all reallocations below twice the
+// final size, so appending costs amortized O(1).
+constexpr std::size_t grown_capacity(std::size_t capacity, std::size_t required)
+{
+    return std::max({required, 2 * capacity, min_growable_capacity});
+}
+
+// Counts of the reallocations of a growable_storage and of the elements they
+// had to carry over into the new storage.
+struct growth_stats
+{
+    std::size_t reallocations{0};
+    std::size_t elements_copied{0};
+};
+
+// Array of Ts that grows geometrically as elements are appended and marks
+// every element it writes dirty. Released blocks are reset to T{}, which
+// leaves them degenerate when drawn, and handed out again by store.
+//
+// It is the CPU side of icg::gl::staging_buffer, whose GPU storage follows
+// capacity(), and has no OpenGL dependency of its own.
+template <typename T>
+class growable_storage
+{
+public:
+    explicit growable_storage(std::size_t initial_capacity = 0)
+        : allocated{initial_capacity}
+    {
+        elements.reserve(initial_capacity);
+    }
+
+    // Elements [0, size()) in use, released ones included.
+    std::size_t size() const { return elements.size(); }
+    std::size_t capacity() const { return allocated; }
+    std::span<const T> data() const { return elements; }
+
+    // Appends `values` after the last element, growing the storage if needed,
+    // and returns the index of the first of them.
+    std::size_t append(std::span<const T> values)
+    {
+        auto const first = elements.size();
+        reserve(first + values.size());
+        elements.insert(elements.end(), values.begin(), values.end());
+        dirty.add(first, elements.size());
+        return first;
+    }
+
+    std::size_t append(const T& value)
+    {
+        return append(std::span<const T>{&value, 1});
+    }
+
+    // Stores `values` in a released block if one is large enough, appending
+    // them otherwise, and returns the index of the first of them.
+    std::size_t store(std::span<const T> values)
+    {
+        if (auto const first = released.allocate(values.size())) {
+            set(*first, values);
+            return *first;
+        }
+        return append(values);
+    }
+
+    void set(std::size_t first, std::span<const T> values)
+    {
+        if (first + values.size() > elements.size()) {
+            throw std::out_of_range{"growable_storage::set past size"};
+        }
+        std::ranges::copy(values, elements.begin() + static_cast<std::ptrdiff_t>(first));
+        dirty.add(first, first + values.size());
+    }
+
+    void set(std::size_t index, const T& value)
+    {
+        set(index, std::span<const T>{&value, 1});
+    }
+
+    // Resets elements [first, first + count) to T{} and makes them available
+    // to store. Releasing an element twice throws std::invalid_argument and
+    // leaves the storage as it was.
+    void release(std::size_t first, std::size_t count)
+    {
+        if (first + count > elements.size()) {
+            throw std::out_of_range{"growable_storage::release past size"};
+        }
+        released.release(first, count);
+        auto const begin = elements.begin() + static_cast<std::ptrdiff_t>(first);
+        std::fill(begin, begin + static_cast<std::ptrdiff_t>(count), T{});
+        dirty.add(first, first + count);
+    }
+
+    // Number of released elements not stored into again.
+    std::size_t num_released() const { return released.size(); }
+
+    // Elements written since the last call to clear_dirty.
+    std::span<const index_range> dirty_ranges() const { return dirty.ranges(); }
+    void clear_dirty() { dirty.clear(); }
+
+    const growth_stats& stats() const { return growth; }
+
+private:
+    void reserve(std::size_t required)
+    {
+        if (required <= allocated) {
+            return;
+        }
+        allocated = grown_capacity(allocated, required);
+        elements.reserve(allocated);
+        ++growth.reallocations;
+        growth.elements_copied += elements.size();
+    }
+
+    std::vector<T> elements;
+    std::size_t allocated;
+    icg::dirty_ranges dirty;
+    free_list released;
+    growth_stats growth;
+};
+
+} // namespace icg
+
+#endif // ICG_GROWABLE_STORAGE_H
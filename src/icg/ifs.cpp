@@ -0,0 +1,272 @@
+#include "ifs.h"
+#include "alias_table.h"
+#include "chaos_game_kernels.h"
+#include "density.h"
+#include "ifs_kernels.h"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace icg {
+
+namespace {
+
+using detail::component;
+using detail::dimension;
+
+template <int D>
+using point = std::conditional_t<D == 2, vec2, vec3>;
+
+template <int D>
+point<D> make_point(const std::array<double, D>& p)
+{
+    if constexpr (D == 2) {
+        return {static_cast<float>(p[0]), static_cast<float>(p[1])};
+    } else {
+        return {static_cast<float>(p[0]), static_cast<float>(p[1]), static_cast<float>(p[2])};
+    }
+}
+
+// Solves (I - linear) p = offset by Gaussian elimination with partial
+// pivoting.
+template <int D>
+point<D> fixed_point(const affine_map<D>& map)
+{
+    double a[D][D + 1];
+    for (int r = 0; r < D; ++r) {
+        for (int c = 0; c < D; ++c) {
+            a[r][c] = (r == c ? 1.0 : 0.0) - map.linear[r][c];
+        }
+        a[r][D] = map.offset[r];
+    }
+    for (int c = 0; c < D; ++c) {
+        auto pivot = c;
+        for (int r = c + 1; r < D; ++r) {
+            if (std::abs(a[r][c]) > std::abs(a[pivot][c])) {
+                pivot = r;
+            }
+        }
+        if (std::abs(a[pivot][c]) < 1e-9) {
+            throw std::invalid_argument{"An IFS map has no fixed point"};
+        }
+        std::swap(a[c], a[pivot]);
+        for (int r = 0; r < D; ++r) {
+            if (r != c) {
+                auto const f = a[r][c] / a[c][c];
+                for (int k = c; k <= D; ++k) {
+                    a[r][k] -= f * a[c][k];
+                }
+            }
+        }
+    }
+    auto p = std::array<double, D>{};
+    for (int r = 0; r < D; ++r) {
+        p[r] = a[r][D] / a[r][r];
+    }
+    return make_point<D>(p);
+}
+
+// Validates the system and calls run(start, advance) with the start of its
+// chains and their step with the widest kernel up to `level` that the CPU
+// supports.
+template <int D, typename Run>
+auto with_ifs_kernel(const ifs<D>& system, simd_level level, Run&& run)
+{
+    auto const count = system.maps.size();
+    if (count == 0 || count > ifs_max_maps) {
+        throw std::invalid_argument{"An IFS takes 1 to " + std::to_string(ifs_max_maps) + " maps"};
+    }
+    if (system.probabilities.size() != count) {
+        throw std::invalid_argument{"An IFS needs one probability per map"};
+    }
+
+    auto maps = detail::ifs_maps{};
+    auto const alias = make_alias_table(system.probabilities);
+    for (std::size_t j = 0; j < count; ++j) {
+        for (int r = 0; r < D; ++r) {
+            for (int c = 0; c < D; ++c) {
+                maps.linear[3 * r + c][j] = system.maps[j].linear[r][c];
+            }
+            maps.offset[r][j] = system.maps[j].offset[r];
+        }
+        maps.threshold[j] = alias.threshold[j];
+        maps.alias[j] = alias.alias[j];
+    }
+
+    // as parallel_chaos_game computes the centroid of its vertices
+    auto start = fixed_point(system.maps[0]);
+    for (std::size_t j = 1; j < count; ++j) {
+        start = start + fixed_point(system.maps[j]);
+    }
+    start = (1.0f / count) * start;
+
+    auto const kernel = detail::select_ifs_kernel(D, count, supported_simd_level(level));
+    auto const advance = [&](const std::uint32_t* keys, std::uint32_t counter, std::size_t steps, float* state, float* tile) {
+        kernel(maps, keys, counter, steps, state, tile);
+    };
+    return run(start, advance);
+}
+
+template <int D, typename Store>
+void parallel_ifs(const ifs<D>& system, std::size_t num_positions, std::uint32_t seed, unsigned num_threads, simd_level level, Store&& store)
+{
+    with_ifs_kernel(system, level, [&](auto start, auto const& advance) {
+        detail::parallel_chains(start, 0, num_positions, seed, num_threads, advance, store);
+    });
+}
+
+template <int D>
+density ifs_density(const ifs<D>& system, std::size_t num_positions, std::uint32_t seed, const density_grid& grid, unsigned num_threads, simd_level level)
+{
+    return with_ifs_kernel(system, level, [&](auto start, auto const& advance) {
+        return detail::density_chains(start, num_positions, seed, num_threads, advance, grid);
+    });
+}
+
+template <typename Vec, std::size_t N>
+ifs<dimension<Vec>> gasket_ifs(const std::array<Vec, N>& vertices)
+{
+    constexpr auto D = dimension<Vec>;
+    auto system = ifs<D>{};
+    for (auto const& v : vertices) {
+        auto map = affine_map<D>{};
+        for (int d = 0; d < D; ++d) {
+            map.linear[d][d] = 0.5f;
+            map.offset[d] = 0.5f * component(v, d);
+        }
+        system.maps.push_back(map);
+        system.probabilities.push_back(1.0f);
+    }
+    return system;
+}
+
+// Map scaling by `scale` towards (1 - scale) * corner.
+template <int D>
+affine_map<D> scaling(float scale, const std::array<float, D>& corner)
+{
+    auto map = affine_map<D>{};
+    for (int d = 0; d < D; ++d) {
+        map.linear[d][d] = scale;
+        map.offset[d] = (1.0f - scale) * corner[d];
+    }
+    return map;
+}
+
+} // namespace
+
+void parallel_ifs(const ifs<2>& system, std::span<vec2> positions, std::uint32_t seed, unsigned num_threads, simd_level level)
+{
+    parallel_ifs(system, positions.size(), seed, num_threads, level, detail::aos_store(positions));
+}
+
+void parallel_ifs(const ifs<3>& system, std::span<vec3> positions, std::uint32_t seed, unsigned num_threads, simd_level level)
+{
+    parallel_ifs(system, positions.size(), seed, num_threads, level, detail::aos_store(positions));
+}
+
+std::vector<vec2> parallel_ifs(const ifs<2>& system, std::size_t num_positions, std::uint32_t seed, unsigned num_threads, simd_level level)
+{
+    auto positions = std::vector<vec2>(num_positions);
+    parallel_ifs(system, std::span{positions}, seed, num_threads, level);
+    return positions;
+}
+
+std::vector<vec3> parallel_ifs(const ifs<3>& system, std::size_t num_positions, std::uint32_t seed, unsigned num_threads, simd_level level)
+{
+    auto positions = std::vector<vec3>(num_positions);
+    parallel_ifs(system, std::span{positions}, seed, num_threads, level);
+    return positions;
+}
+
+density ifs_density(const ifs<2>& system, std::size_t num_positions, std::uint32_t seed, const density_grid& grid, unsigned num_threads, simd_level level)
+{
+    return ifs_density<2>(system, num_positions, seed, grid, num_threads, level);
+}
+
+density ifs_density(const ifs<3>& system, std::size_t num_positions, std::uint32_t seed, const density_grid& grid, unsigned num_threads, simd_level level)
+{
+    return ifs_density<3>(system, num_positions, seed, grid, num_threads, level);
+}
+
+ifs<2> gasket_ifs(const std::array<vec2, 3>& vertices)
+{
+    return gasket_ifs<vec2, 3>(vertices);
+}
+
+ifs<3> gasket_ifs(const std::array<vec3, 4>& vertices)
+{
+    return gasket_ifs<vec3, 4>(vertices);
+}
+
+ifs<2> heighway_dragon()
+{
+    // z -> (1 + i) z / 2 and z -> 1 - (1 - i) z / 2, conjugated with
+    // p -> 4/3 p - (5/9, 2/9)
+    return {
+        {
+            {{{{0.5f, -0.5f}, {0.5f, 0.5f}}}, {-7.0f / 18.0f, 3.0f / 18.0f}},
+            {{{{-0.5f, -0.5f}, {0.5f, -0.5f}}}, {7.0f / 18.0f, -1.0f / 18.0f}},
+        },
+        {1.0f, 1.0f}};
+}
+
+ifs<2> barnsley_fern()
+{
+    auto system = ifs<2>{
+        {
+            {{{{0.0f, 0.0f}, {0.0f, 0.16f}}}, {0.0f, 0.0f}},
+            {{{{0.85f, 0.04f}, {-0.04f, 0.85f}}}, {0.0f, 1.6f}},
+            {{{{0.2f, -0.26f}, {0.23f, 0.22f}}}, {0.0f, 1.6f}},
+            {{{{-0.15f, 0.28f}, {0.26f, 0.24f}}}, {0.0f, 0.44f}},
+        },
+        {0.01f, 0.85f, 0.07f, 0.07f}};
+    for (auto& map : system.maps) {
+        // conjugate with p -> 0.2 p - (0, 1), which moves y from [0, 10] to [-1, 1]
+        map.offset = {0.2f * map.offset[0] + map.linear[0][1], 0.2f * map.offset[1] + map.linear[1][1] - 1.0f};
+    }
+    return system;
+}
+
+ifs<2> sierpinski_carpet()
+{
+    auto system = ifs<2>{};
+    for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+            if (x != 0 || y != 0) {
+                system.maps.push_back(scaling<2>(1.0f / 3.0f, {static_cast<float>(x), static_cast<float>(y)}));
+                system.probabilities.push_back(1.0f);
+            }
+        }
+    }
+    return system;
+}
+
+ifs<3> sierpinski_pyramid()
+{
+    auto system = ifs<3>{};
+    for (auto const& corner : {
+             std::array{-1.0f, -1.0f, -1.0f},
+             std::array{1.0f, -1.0f, -1.0f},
+             std::array{1.0f, -1.0f, 1.0f},
+             std::array{-1.0f, -1.0f, 1.0f},
+             std::array{0.0f, 1.0f, 0.0f}}) {
+        system.maps.push_back(scaling<3>(0.5f, corner));
+        system.probabilities.push_back(1.0f);
+    }
+    return system;
+}
+
+ifs<3> cantor_dust()
+{
+    auto system = ifs<3>{};
+    for (int corner = 0; corner < 8; ++corner) {
+        auto const c = [&](int bit) { return corner >> bit & 1 ? 1.0f : -1.0f; };
+        system.maps.push_back(scaling<3>(1.0f / 3.0f, {c(0), c(1), c(2)}));
+        system.probabilities.push_back(1.0f);
+    }
+    return system;
+}
+
+} // namespace icg
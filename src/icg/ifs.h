@@ -0,0 +1,68 @@
+#ifndef ICG_IFS_H
+#define ICG_IFS_H
+
+#include "simd.h"
+#include "vector.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace icg {
+
+// Affine map p -> linear * p + offset of D-dimensional points. Component r of
+// the image is (linear[r][0] * p[0] + linear[r][1] * p[1] + ...) + offset[r],
+// summed left to right with every product rounded on its own, in every kernel.
+template <int D>
+struct affine_map
+{
+    std::array<std::array<float, D>, D> linear;
+    std::array<float, D> offset;
+};
+
+// Iterated function system: each step of its chaos game applies map j with
+// probability proportional to probabilities[j], which need not sum to 1.
+template <int D>
+struct ifs
+{
+    std::vector<affine_map<D>> maps;
+    std::vector<float> probabilities;
+};
+
+// Most maps an ifs can have, so that the AVX2 kernels look them up from a
+// single register.
+constexpr std::size_t ifs_max_maps = 8;
+
+// Fills `positions` with the chaos game of `system` in independent chains of
+// chaos_game_chain_length points, like parallel_chaos_game: chain c starts at
+// the centroid of the fixed points of the maps, draws from stream c of a
+// counter_rng seeded with `seed` and discards its first chaos_game_burn_in
+// points. The map of every step is sampled from an alias_table, and the
+// kernels are specialized for each number of maps and dimension, so their
+// loop has no branches. The result only depends on the seed, so it is byte
+// for byte identical at any thread count and SIMD level.
+//
+// Throws std::invalid_argument if the system has no maps, more than
+// ifs_max_maps, invalid probabilities or a map without a fixed point.
+void parallel_ifs(const ifs<2>& system, std::span<vec2> positions, std::uint32_t seed, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+void parallel_ifs(const ifs<3>& system, std::span<vec3> positions, std::uint32_t seed, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+
+std::vector<vec2> parallel_ifs(const ifs<2>& system, std::size_t num_positions, std::uint32_t seed, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+std::vector<vec3> parallel_ifs(const ifs<3>& system, std::size_t num_positions, std::uint32_t seed, unsigned num_threads = 0, simd_level level = simd_level::avx512);
+
+// The gasket as an IFS: one map halfway towards each vertex, all equally
+// likely. Its parallel_ifs is bit for bit parallel_chaos_game of the vertices.
+ifs<2> gasket_ifs(const std::array<vec2, 3>& vertices);
+ifs<3> gasket_ifs(const std::array<vec3, 4>& vertices);
+
+// Classic fractals, scaled to about [-1, 1].
+ifs<2> heighway_dragon();
+ifs<2> barnsley_fern();
+ifs<2> sierpinski_carpet();
+ifs<3> sierpinski_pyramid();
+ifs<3> cantor_dust();
+
+} // namespace icg
+
+#endif // ICG_IFS_H
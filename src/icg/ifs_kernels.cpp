@@ -0,0 +1,256 @@
+#include "ifs_kernels.h"
+#include "alias_table.h"
+#include "ifs.h"
+#include "random.h"
+#include "random_kernels.h"
+#include <utility>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ICG_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace icg::detail {
+
+namespace {
+
+constexpr auto lanes = chaos_game_lanes;
+constexpr auto tile_steps = chaos_game_tile_steps;
+
+// Hides a product from the optimizer so that it is not fused with the sum it
+// feeds: outside ISO mode GCC contracts a * b + c into an FMA wherever the
+// target has one, which rounds differently from the kernels without it.
+inline float unfused(float x)
+{
+#ifdef ICG_X86_KERNELS
+    asm("" : "+x"(x));
+#endif
+    return x;
+}
+
+#ifdef ICG_X86_KERNELS
+
+__attribute__((target("avx2")))
+inline __m256 unfused(__m256 x)
+{
+    asm("" : "+x"(x));
+    return x;
+}
+
+__attribute__((target("avx512f")))
+inline __m512 unfused(__m512 x)
+{
+    asm("" : "+v"(x));
+    return x;
+}
+
+#endif // ICG_X86_KERNELS
+
+template <int D, std::size_t N>
+void ifs_kernel_scalar(
+    const ifs_maps& maps,
+    const std::uint32_t* keys,
+    std::uint32_t counter,
+    std::size_t steps,
+    float* state,
+    float* tile)
+{
+    for (std::size_t l = 0; l < lanes; ++l) {
+        auto const rng = counter_rng{keys[l]};
+        float p[D];
+        for (int d = 0; d < D; ++d) {
+            p[d] = state[d * lanes + l];
+        }
+        for (std::size_t t = 0; t < steps; ++t) {
+            auto const j = sample_alias(maps.threshold, maps.alias, N, rng(counter + static_cast<std::uint32_t>(t)));
+            float q[D];
+            for (int r = 0; r < D; ++r) {
+                auto sum = unfused(maps.linear[3 * r][j] * p[0]);
+                for (int c = 1; c < D; ++c) {
+                    sum = sum + unfused(maps.linear[3 * r + c][j] * p[c]);
+                }
+                q[r] = sum + maps.offset[r][j];
+            }
+            for (int d = 0; d < D; ++d) {
+                p[d] = q[d];
+                tile[(d * tile_steps + t) * lanes + l] = p[d];
+            }
+        }
+        for (int d = 0; d < D; ++d) {
+            state[d * lanes + l] = p[d];
+        }
+    }
+}
+
+#ifdef ICG_X86_KERNELS
+
+// The kernels below replicate counter_rng and sample_alias lane by lane.
+
+template <int D, std::size_t N>
+__attribute__((target("avx2")))
+void ifs_kernel_avx2(
+    const ifs_maps& maps,
+    const std::uint32_t* keys,
+    std::uint32_t counter,
+    std::size_t steps,
+    float* state,
+    float* tile)
+{
+    constexpr int halves = lanes / 8;
+
+    __m256 linear[D * D];
+    __m256 offset[D];
+    __m256 p[D][halves];
+    for (int r = 0; r < D; ++r) {
+        for (int c = 0; c < D; ++c) {
+            linear[D * r + c] = _mm256_load_ps(maps.linear[3 * r + c]);
+        }
+        offset[r] = _mm256_load_ps(maps.offset[r]);
+        for (int h = 0; h < halves; ++h) {
+            p[r][h] = _mm256_loadu_ps(state + r * lanes + 8 * h);
+        }
+    }
+    auto const threshold = _mm256_load_si256(reinterpret_cast<const __m256i*>(maps.threshold));
+    auto const alias = _mm256_load_si256(reinterpret_cast<const __m256i*>(maps.alias));
+
+    __m256i key[halves];
+    for (int h = 0; h < halves; ++h) {
+        key[h] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + 8 * h));
+    }
+
+    auto const count = _mm256_set1_epi32(static_cast<int>(N));
+    auto const low = _mm256_set1_epi32(0xffff);
+
+    for (std::size_t t = 0; t < steps; ++t) {
+        auto const weyl = _mm256_set1_epi32(static_cast<int>((counter + static_cast<std::uint32_t>(t)) * 0x9e3779b9u));
+        for (int h = 0; h < halves; ++h) {
+            auto const x = counter_rng_avx2(weyl, key[h]);
+            auto const column = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(x, 16), count), 16);
+            // thresholds are at most 2^16, so the signed comparison is exact
+            auto const keep = _mm256_cmpgt_epi32(_mm256_permutevar8x32_epi32(threshold, column), _mm256_and_si256(x, low));
+            auto const j = _mm256_blendv_epi8(_mm256_permutevar8x32_epi32(alias, column), column, keep);
+
+            __m256 q[D];
+            for (int r = 0; r < D; ++r) {
+                auto sum = unfused(_mm256_mul_ps(_mm256_permutevar8x32_ps(linear[D * r], j), p[0][h]));
+                for (int c = 1; c < D; ++c) {
+                    sum = _mm256_add_ps(sum, unfused(_mm256_mul_ps(_mm256_permutevar8x32_ps(linear[D * r + c], j), p[c][h])));
+                }
+                q[r] = _mm256_add_ps(sum, _mm256_permutevar8x32_ps(offset[r], j));
+            }
+            for (int d = 0; d < D; ++d) {
+                p[d][h] = q[d];
+                _mm256_storeu_ps(tile + (d * tile_steps + t) * lanes + 8 * h, p[d][h]);
+            }
+        }
+    }
+
+    for (int d = 0; d < D; ++d) {
+        for (int h = 0; h < halves; ++h) {
+            _mm256_storeu_ps(state + d * lanes + 8 * h, p[d][h]);
+        }
+    }
+}
+
+// GCC 12 reports the deliberately undefined pass-through operands inside its
+// own AVX-512 intrinsics as maybe uninitialized.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+template <int D, std::size_t N>
+__attribute__((target("avx512f")))
+void ifs_kernel_avx512(
+    const ifs_maps& maps,
+    const std::uint32_t* keys,
+    std::uint32_t counter,
+    std::size_t steps,
+    float* state,
+    float* tile)
+{
+    static_assert(lanes == 16);
+
+    __m512 linear[D * D];
+    __m512 offset[D];
+    __m512 p[D];
+    for (int r = 0; r < D; ++r) {
+        for (int c = 0; c < D; ++c) {
+            linear[D * r + c] = _mm512_load_ps(maps.linear[3 * r + c]);
+        }
+        offset[r] = _mm512_load_ps(maps.offset[r]);
+        p[r] = _mm512_loadu_ps(state + r * lanes);
+    }
+    auto const threshold = _mm512_load_si512(maps.threshold);
+    auto const alias = _mm512_load_si512(maps.alias);
+
+    auto const key = _mm512_loadu_si512(keys);
+    auto const count = _mm512_set1_epi32(static_cast<int>(N));
+    auto const low = _mm512_set1_epi32(0xffff);
+
+    for (std::size_t t = 0; t < steps; ++t) {
+        auto const weyl = _mm512_set1_epi32(static_cast<int>((counter + static_cast<std::uint32_t>(t)) * 0x9e3779b9u));
+        auto const x = counter_rng_avx512(weyl, key);
+        auto const column = _mm512_srli_epi32(_mm512_mullo_epi32(_mm512_srli_epi32(x, 16), count), 16);
+        auto const keep = _mm512_cmplt_epu32_mask(_mm512_and_si512(x, low), _mm512_permutexvar_epi32(column, threshold));
+        auto const j = _mm512_mask_blend_epi32(keep, _mm512_permutexvar_epi32(column, alias), column);
+
+        __m512 q[D];
+        for (int r = 0; r < D; ++r) {
+            auto sum = unfused(_mm512_mul_ps(_mm512_permutexvar_ps(j, linear[D * r]), p[0]));
+            for (int c = 1; c < D; ++c) {
+                sum = _mm512_add_ps(sum, unfused(_mm512_mul_ps(_mm512_permutexvar_ps(j, linear[D * r + c]), p[c])));
+            }
+            q[r] = _mm512_add_ps(sum, _mm512_permutexvar_ps(j, offset[r]));
+        }
+        for (int d = 0; d < D; ++d) {
+            p[d] = q[d];
+            _mm512_storeu_ps(tile + (d * tile_steps + t) * lanes, p[d]);
+        }
+    }
+
+    for (int d = 0; d < D; ++d) {
+        _mm512_storeu_ps(state + d * lanes, p[d]);
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // ICG_X86_KERNELS
+
+template <int D, std::size_t N>
+ifs_kernel select_ifs_kernel(simd_level level)
+{
+#ifdef ICG_X86_KERNELS
+    switch (level) {
+        case simd_level::avx512:
+            return ifs_kernel_avx512<D, N>;
+        case simd_level::avx2:
+            return ifs_kernel_avx2<D, N>;
+        case simd_level::scalar:
+            break;
+    }
+#else
+    static_cast<void>(level);
+#endif
+    return ifs_kernel_scalar<D, N>;
+}
+
+template <int D, std::size_t... I>
+ifs_kernel select_ifs_kernel(std::size_t count, simd_level level, std::index_sequence<I...>)
+{
+    constexpr ifs_kernel (*select[])(simd_level) = {select_ifs_kernel<D, I + 1>...};
+    return select[count - 1](level);
+}
+
+} // namespace
+
+ifs_kernel select_ifs_kernel(int dimension, std::size_t count, simd_level level)
+{
+    constexpr auto counts = std::make_index_sequence<ifs_max_maps>{};
+    return dimension == 2 ? select_ifs_kernel<2>(count, level, counts) : select_ifs_kernel<3>(count, level, counts);
+}
+
+} // namespace icg::detail
@@ -0,0 +1,41 @@
+#ifndef ICG_IFS_KERNELS_H
+#define ICG_IFS_KERNELS_H
+
+#include "chaos_game_kernels.h"
+#include "simd.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace icg::detail {
+
+// Maps of an ifs component by component, padded to a full register: entry
+// (r, c) of the linear part of map j is linear[3 * r + c][j] and component r
+// of its offset is offset[r][j]. The alias_table of its probabilities is
+// threshold and alias.
+struct ifs_maps
+{
+    alignas(64) float linear[9][chaos_game_lanes];
+    alignas(64) float offset[3][chaos_game_lanes];
+    alignas(64) std::uint32_t threshold[chaos_game_lanes];
+    alignas(64) std::uint32_t alias[chaos_game_lanes];
+};
+
+// Advances every lane by `steps` <= chaos_game_tile_steps points, with the
+// state and output layout of a chaos_game_kernel, sampling the map of step t
+// from the counter_rng of the lane at counter + t.
+using ifs_kernel = void (*)(
+    const ifs_maps& maps,
+    const std::uint32_t* keys,
+    std::uint32_t counter,
+    std::size_t steps,
+    float* state,
+    float* tile);
+
+// The kernel for `dimension` (2 or 3) components and `count` maps, 1 to
+// ifs_max_maps, at the given level, which must be supported by the CPU. All
+// kernels produce bit-identical results.
+ifs_kernel select_ifs_kernel(int dimension, std::size_t count, simd_level level);
+
+} // namespace icg::detail
+
+#endif // ICG_IFS_KERNELS_H
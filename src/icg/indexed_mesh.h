@@ -0,0 +1,65 @@
+#ifndef ICG_INDEXED_MESH_H
+#define ICG_INDEXED_MESH_H
+
+#include "vector.h"
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+namespace icg {
+
+// Triangles drawn with glDrawElements from vertices stored once each. The
+// indices are 16 bit while every vertex can be addressed with them, 32 bit
+// otherwise. Colors are per vertex and left empty by 2D meshes.
+template <typename Vec>
+struct indexed_triangles
+{
+    std::vector<Vec> positions;
+    std::vector<vec3> colors;
+    std::variant<std::vector<std::uint16_t>, std::vector<std::uint32_t>> indices;
+
+    std::size_t num_vertices() const { return positions.size(); }
+
+    std::size_t num_indices() const
+    {
+        return std::visit([](const auto& i) { return i.size(); }, indices);
+    }
+
+    // Size of one index in bytes, 2 or 4.
+    std::size_t index_size() const
+    {
+        return indices.index() == 0 ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+    }
+};
+
+// What an indexed mesh saves over drawing the same triangles with
+// glDrawArrays, which stores every vertex of every triangle.
+struct mesh_reduction
+{
+    std::size_t flat_vertices;
+    std::size_t indexed_vertices;
+    std::size_t flat_bytes;
+    std::size_t indexed_bytes;
+
+    // Whether indexing makes the mesh smaller at all. It does not for a 2D
+    // gasket that needs 32-bit indices, whose triangles share only corners.
+    bool saves() const { return indexed_bytes < flat_bytes; }
+};
+
+// The bytes are counted for the vertices as they are uploaded, one `Vertex`
+// apiece, e.g. with the colors packed, rather than as the mesh stores them.
+template <typename Vertex, typename Vec>
+mesh_reduction reduction(const indexed_triangles<Vec>& mesh)
+{
+    return mesh_reduction{
+        mesh.num_indices(),
+        mesh.num_vertices(),
+        mesh.num_indices() * sizeof(Vertex),
+        mesh.num_vertices() * sizeof(Vertex) + mesh.num_indices() * mesh.index_size()
+    };
+}
+
+} // namespace icg
+
+#endif // ICG_INDEXED_MESH_H
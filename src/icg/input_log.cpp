@@ -0,0 +1,139 @@
+#include "input_log.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace icg {
+
+namespace {
+
+static_assert(std::is_trivially_copyable_v<input_event>);
+
+constexpr std::array<char, 8> magic = {'I', 'C', 'G', 'I', 'N', 'P', 'U', 'T'};
+constexpr std::uint32_t version = 2;
+
+struct header
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t event_size;
+};
+
+input_session& session()
+{
+    static auto s = input_session{};
+    return s;
+}
+
+} // namespace
+
+void set_default_input_session(input_session s)
+{
+    session() = std::move(s);
+}
+
+const input_session& default_input_session()
+{
+    return session();
+}
+
+input_log_writer::input_log_writer(const std::filesystem::path& path)
+    : file{path, std::ios::binary | std::ios::trunc}
+{
+    if (!file) {
+        throw std::runtime_error{"Cannot write input log " + path.string()};
+    }
+    auto const h = header{magic, version, sizeof(input_event)};
+    file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    pending.reserve(block_size);
+}
+
+input_log_writer::~input_log_writer()
+{
+    try {
+        flush();
+    } catch (...) {
+        // nothing sensible to do about a failed write while unwinding
+    }
+}
+
+void input_log_writer::write(const input_event& event)
+{
+    pending.push_back(event);
+    if (pending.size() == block_size) {
+        flush();
+    }
+}
+
+void input_log_writer::flush()
+{
+    file.write(reinterpret_cast<const char*>(pending.data()), static_cast<std::streamsize>(pending.size() * sizeof(input_event)));
+    file.flush();
+    if (!file) {
+        throw std::runtime_error{"Failed to write input log"};
+    }
+    written += pending.size();
+    pending.clear();
+}
+
+std::vector<input_event> read_input_log(const std::filesystem::path& path)
+{
+    auto file = std::ifstream{path, std::ios::binary};
+    if (!file) {
+        throw std::runtime_error{"Cannot read input log " + path.string()};
+    }
+    auto h = header{};
+    file.read(reinterpret_cast<char*>(&h), sizeof(h));
+    if (!file || h.magic != magic) {
+        throw std::runtime_error{path.string() + " is not an input log"};
+    }
+    if (h.version != version || h.event_size != sizeof(input_event)) {
+        throw std::runtime_error{"Unsupported version of input log " + path.string()};
+    }
+
+    auto const bytes = std::filesystem::file_size(path) - sizeof(h);
+    if (bytes % sizeof(input_event) != 0) {
+        throw std::runtime_error{"Truncated input log " + path.string()};
+    }
+    auto events = std::vector<input_event>(bytes / sizeof(input_event));
+    file.read(reinterpret_cast<char*>(events.data()), static_cast<std::streamsize>(bytes));
+    if (!file) {
+        throw std::runtime_error{"Failed to read input log " + path.string()};
+    }
+    return events;
+}
+
+input_replay::input_replay(std::vector<input_event> events)
+    : events{std::move(events)}
+{
+}
+
+std::span<const input_event> input_replay::due(double seconds)
+{
+    auto const rest = std::span{events}.subspan(next);
+    auto const end = std::ranges::find_if(rest, [seconds](const input_event& e) { return e.seconds > seconds; });
+    return take(next + static_cast<std::size_t>(end - rest.begin()));
+}
+
+std::span<const input_event> input_replay::next_frame()
+{
+    if (done()) {
+        return {};
+    }
+    auto const frame = events[next].frame;
+    auto end = next;
+    while (end < events.size() && events[end].frame == frame) {
+        ++end;
+    }
+    return take(end);
+}
+
+std::span<const input_event> input_replay::take(std::size_t end)
+{
+    auto const first = std::exchange(next, end);
+    return std::span{events}.subspan(first, end - first);
+}
+
+} // namespace icg
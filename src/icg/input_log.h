@@ -0,0 +1,114 @@
+#ifndef ICG_INPUT_LOG_H
+#define ICG_INPUT_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <vector>
+
+namespace icg {
+
+enum class input_kind : std::uint8_t
+{
+    key,
+    mouse_button,
+    cursor,
+    ui
+};
+
+// One input event as a window's callbacks received it. code, action and mods
+// hold the values of the tinygl enums; x and y are the cursor position in
+// window coordinates, which mouse button events carry as well since the
+// demos read it from their callbacks. UI events carry the control that was
+// used in code and its new value in scancode.
+struct input_event
+{
+    double seconds{0.0};
+    std::uint32_t frame{0};
+    std::int32_t code{0};
+    std::int32_t scancode{0};
+    float x{0.0f};
+    float y{0.0f};
+    input_kind kind{input_kind::key};
+    std::uint8_t action{0};
+    std::uint16_t mods{0};
+};
+
+static_assert(sizeof(input_event) == 32);
+
+// Where the input of a demo window comes from and goes to: recorded to
+// `record` if it is not empty, and replayed from `replay` instead of read from
+// the window if that is not empty, at the original speed or, if `fast`, one
+// recorded frame per frame.
+struct input_session
+{
+    std::filesystem::path record;
+    std::filesystem::path replay;
+    bool fast{false};
+};
+
+// Session of every input_window created afterwards. Set once at startup,
+// before any window exists.
+void set_default_input_session(input_session session);
+const input_session& default_input_session();
+
+// Writes input events to a binary log: an 8 byte magic, the format version
+// and the size of an event, followed by the events as they are laid out in
+// memory. Logs are meant to be replayed on the machine that recorded them, or
+// one of the same byte order. Events are buffered and written in blocks.
+class input_log_writer
+{
+public:
+    explicit input_log_writer(const std::filesystem::path& path);
+
+    input_log_writer(const input_log_writer&) = delete;
+    input_log_writer& operator=(const input_log_writer&) = delete;
+
+    // Writes the events still buffered.
+    ~input_log_writer();
+
+    void write(const input_event& event);
+    void flush();
+
+    std::size_t size() const { return written + pending.size(); }
+
+private:
+    static constexpr std::size_t block_size = 4096;
+
+    std::ofstream file;
+    std::vector<input_event> pending;
+    std::size_t written{0};
+};
+
+// Reads back a log of input_log_writer. Throws std::runtime_error if it is not
+// one or is truncated.
+std::vector<input_event> read_input_log(const std::filesystem::path& path);
+
+// Hands out the events of a log in order, either as time goes by or frame by
+// frame.
+class input_replay
+{
+public:
+    explicit input_replay(std::vector<input_event> events);
+
+    // Events recorded up to `seconds` into the session not handed out yet.
+    std::span<const input_event> due(double seconds);
+
+    // Events of the next recorded frame that has any.
+    std::span<const input_event> next_frame();
+
+    bool done() const { return next == events.size(); }
+    std::size_t size() const { return events.size(); }
+
+private:
+    std::span<const input_event> take(std::size_t end);
+
+    std::vector<input_event> events;
+    std::size_t next{0};
+};
+
+} // namespace icg
+
+#endif // ICG_INPUT_LOG_H
@@ -0,0 +1,205 @@
+#include "instancing.h"
+#include "parallel.h"
+#include "random.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ICG_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace icg {
+
+namespace {
+
+constexpr auto to_radians = std::numbers::pi_v<float> / 180.0f;
+
+// Angle of `rate` degrees per second after `seconds`, reduced to [0, 360)
+// before it is converted, so that long runs keep their precision.
+float angle(float rate, float seconds)
+{
+    auto const degrees = rate * seconds;
+    return to_radians * (degrees - 360.0f * std::floor(degrees * (1.0f / 360.0f)));
+}
+
+// flip_z * translate(offset) * scale(s) * rz * ry * rx, written out.
+void fill_instances_scalar(const instance_motion& motion, float seconds, std::size_t first, std::size_t last, mat4* transforms)
+{
+    auto const s = motion.scale;
+    for (auto i = first; i < last; ++i) {
+        auto const x = fast_sincos(angle(motion.rate[0][i], seconds));
+        auto const y = fast_sincos(angle(motion.rate[1][i], seconds));
+        auto const z = fast_sincos(angle(motion.rate[2][i], seconds));
+        transforms[i] = mat4{{
+            s * (z.cos * y.cos),
+            s * (z.sin * y.cos),
+            s * y.sin,
+            0.0f,
+            s * (z.cos * y.sin * x.sin - z.sin * x.cos),
+            s * (z.sin * y.sin * x.sin + z.cos * x.cos),
+            -s * (y.cos * x.sin),
+            0.0f,
+            s * (z.cos * y.sin * x.cos + z.sin * x.sin),
+            s * (z.sin * y.sin * x.cos - z.cos * x.sin),
+            -s * (y.cos * x.cos),
+            0.0f,
+            motion.offset[0][i],
+            motion.offset[1][i],
+            -motion.offset[2][i],
+            1.0f
+        }};
+    }
+}
+
+#ifdef ICG_X86_KERNELS
+
+struct sin_cos8
+{
+    __m256 sin;
+    __m256 cos;
+};
+
+// fast_sincos eight lanes at a time, the quadrant applied with blends and sign
+// flips instead of a branch.
+__attribute__((target("avx2")))
+sin_cos8 fast_sincos8(__m256 radians)
+{
+    auto const quadrant = _mm256_round_ps(
+        _mm256_mul_ps(radians, _mm256_set1_ps(std::numbers::inv_pi_v<float> * 2.0f)),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    auto r = radians;
+    r = _mm256_sub_ps(r, _mm256_mul_ps(quadrant, _mm256_set1_ps(1.5703125f)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(quadrant, _mm256_set1_ps(4.837512969970703125e-4f)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(quadrant, _mm256_set1_ps(7.54978995489188216e-8f)));
+
+    auto const r2 = _mm256_mul_ps(r, r);
+    auto ps = _mm256_add_ps(_mm256_set1_ps(8.3321608736e-3f), _mm256_mul_ps(r2, _mm256_set1_ps(-1.9515295891e-4f)));
+    ps = _mm256_add_ps(_mm256_set1_ps(-1.6666654611e-1f), _mm256_mul_ps(r2, ps));
+    auto const s = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), ps));
+    auto pc = _mm256_add_ps(_mm256_set1_ps(-1.388731625493765e-3f), _mm256_mul_ps(r2, _mm256_set1_ps(2.443315711809948e-5f)));
+    pc = _mm256_add_ps(_mm256_set1_ps(4.166664568298827e-2f), _mm256_mul_ps(r2, pc));
+    auto const c = _mm256_add_ps(
+        _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)),
+        _mm256_mul_ps(_mm256_mul_ps(r2, r2), pc));
+
+    // quadrant q: (sin, cos) = (s, c), (c, -s), (-s, -c), (-c, s)
+    auto const q = _mm256_cvtps_epi32(quadrant);
+    auto const odd = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+    auto const sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+    auto const cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+    return {
+        _mm256_xor_ps(_mm256_blendv_ps(s, c, odd), sin_sign),
+        _mm256_xor_ps(_mm256_blendv_ps(c, s, odd), cos_sign)
+    };
+}
+
+__attribute__((target("avx2")))
+__m256 angle8(const float* rate, __m256 seconds)
+{
+    auto const degrees = _mm256_mul_ps(_mm256_loadu_ps(rate), seconds);
+    auto const turns = _mm256_floor_ps(_mm256_mul_ps(degrees, _mm256_set1_ps(1.0f / 360.0f)));
+    return _mm256_mul_ps(_mm256_set1_ps(to_radians), _mm256_sub_ps(degrees, _mm256_mul_ps(_mm256_set1_ps(360.0f), turns)));
+}
+
+// The matrices of eight instances are built component by component and then
+// written out instance by instance from a small aligned tile.
+__attribute__((target("avx2")))
+void fill_instances_avx2(const instance_motion& motion, float seconds, std::size_t first, std::size_t last, mat4* transforms)
+{
+    auto const t = _mm256_set1_ps(seconds);
+    auto const s = _mm256_set1_ps(motion.scale);
+    auto const minus_s = _mm256_set1_ps(-motion.scale);
+    auto const zero = _mm256_setzero_ps();
+
+    auto i = first;
+    for (; i + 8 <= last; i += 8) {
+        auto const x = fast_sincos8(angle8(motion.rate[0].data() + i, t));
+        auto const y = fast_sincos8(angle8(motion.rate[1].data() + i, t));
+        auto const z = fast_sincos8(angle8(motion.rate[2].data() + i, t));
+        auto const zcys = _mm256_mul_ps(z.cos, y.sin);
+        auto const zsys = _mm256_mul_ps(z.sin, y.sin);
+
+        alignas(32) float tile[16][8];
+        _mm256_store_ps(tile[0], _mm256_mul_ps(s, _mm256_mul_ps(z.cos, y.cos)));
+        _mm256_store_ps(tile[1], _mm256_mul_ps(s, _mm256_mul_ps(z.sin, y.cos)));
+        _mm256_store_ps(tile[2], _mm256_mul_ps(s, y.sin));
+        _mm256_store_ps(tile[3], zero);
+        _mm256_store_ps(tile[4], _mm256_mul_ps(s, _mm256_sub_ps(_mm256_mul_ps(zcys, x.sin), _mm256_mul_ps(z.sin, x.cos))));
+        _mm256_store_ps(tile[5], _mm256_mul_ps(s, _mm256_add_ps(_mm256_mul_ps(zsys, x.sin), _mm256_mul_ps(z.cos, x.cos))));
+        _mm256_store_ps(tile[6], _mm256_mul_ps(minus_s, _mm256_mul_ps(y.cos, x.sin)));
+        _mm256_store_ps(tile[7], zero);
+        _mm256_store_ps(tile[8], _mm256_mul_ps(s, _mm256_add_ps(_mm256_mul_ps(zcys, x.cos), _mm256_mul_ps(z.sin, x.sin))));
+        _mm256_store_ps(tile[9], _mm256_mul_ps(s, _mm256_sub_ps(_mm256_mul_ps(zsys, x.cos), _mm256_mul_ps(z.cos, x.sin))));
+        _mm256_store_ps(tile[10], _mm256_mul_ps(minus_s, _mm256_mul_ps(y.cos, x.cos)));
+        _mm256_store_ps(tile[11], zero);
+        _mm256_store_ps(tile[12], _mm256_loadu_ps(motion.offset[0].data() + i));
+        _mm256_store_ps(tile[13], _mm256_loadu_ps(motion.offset[1].data() + i));
+        _mm256_store_ps(tile[14], _mm256_sub_ps(zero, _mm256_loadu_ps(motion.offset[2].data() + i)));
+        _mm256_store_ps(tile[15], _mm256_set1_ps(1.0f));
+
+        for (int l = 0; l < 8; ++l) {
+            auto& m = transforms[i + static_cast<std::size_t>(l)].m;
+            for (int k = 0; k < 16; ++k) {
+                m[k] = tile[k][l];
+            }
+        }
+    }
+    fill_instances_scalar(motion, seconds, i, last, transforms);
+}
+
+#endif // ICG_X86_KERNELS
+
+} // namespace
+
+instance_motion instance_grid(std::size_t side, std::uint32_t seed)
+{
+    auto motion = instance_motion{};
+    auto const count = side * side;
+    for (int d = 0; d < 3; ++d) {
+        motion.offset[d].resize(count);
+        motion.rate[d].resize(count);
+    }
+
+    auto const cell = 2.0f / static_cast<float>(side);
+    auto const rng = counter_rng::stream(seed, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        motion.offset[0][i] = -1.0f + cell * (static_cast<float>(i % side) + 0.5f);
+        motion.offset[1][i] = -1.0f + cell * (static_cast<float>(i / side) + 0.5f);
+        motion.offset[2][i] = 0.0f;
+        for (int d = 0; d < 3; ++d) {
+            auto const random = rng(static_cast<std::uint32_t>(3 * i) + static_cast<std::uint32_t>(d));
+            motion.rate[d][i] = 360.0f * (static_cast<float>(random >> 8) * 0x1p-24f) - 180.0f;
+        }
+    }
+    // a unit cube rotated any way fits in a sphere of diameter sqrt(3)
+    motion.scale = cell / std::numbers::sqrt3_v<float>;
+    return motion;
+}
+
+void fill_instance_transforms(
+    const instance_motion& motion,
+    float seconds,
+    std::span<mat4> transforms,
+    unsigned num_threads,
+    simd_level level)
+{
+    auto fill = fill_instances_scalar;
+#ifdef ICG_X86_KERNELS
+    if (supported_simd_level(level) >= simd_level::avx2) {
+        fill = fill_instances_avx2;
+    }
+#else
+    static_cast<void>(level);
+#endif
+
+    auto const count = std::min(motion.size(), transforms.size());
+    auto const num_blocks = (count + instance_block_size - 1) / instance_block_size;
+    parallel_for(num_blocks, num_threads, [&](std::size_t block) {
+        auto const first = block * instance_block_size;
+        fill(motion, seconds, first, std::min(first + instance_block_size, count), transforms.data());
+    });
+}
+
+} // namespace icg
@@ -0,0 +1,49 @@
+#ifndef ICG_INSTANCING_H
+#define ICG_INSTANCING_H
+
+#include "simd.h"
+#include "transform.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace icg {
+
+// Placement and motion of the instances of a shared mesh, component by
+// component: instance i sits at (offset[0][i], offset[1][i], offset[2][i])
+// and turns about the x, y and z axes at rate[0][i], rate[1][i] and
+// rate[2][i] degrees per second.
+struct instance_motion
+{
+    std::vector<float> offset[3];
+    std::vector<float> rate[3];
+    float scale{1.0f};
+
+    std::size_t size() const { return offset[0].size(); }
+};
+
+// side x side instances filling [-1, 1]^2 in the z = 0 plane, scaled to fit
+// their cell, with rates of up to 180 degrees per second about each axis
+// drawn from a counter_rng seeded with `seed`.
+instance_motion instance_grid(std::size_t side, std::uint32_t seed);
+
+// Instances per work item of fill_instance_transforms.
+constexpr std::size_t instance_block_size = 4096;
+
+// Writes the model matrix of every instance at time `seconds` into
+// `transforms`, which must hold motion.size() matrices: the rotation of
+// icg::rotation by rate * seconds, scaled, translated to the offset and with
+// z flipped as cube.vert expects. Blocks of instances are filled on up to
+// `num_threads` threads (0 uses all cores), eight at a time with AVX2 from
+// simd_level::avx2 up if the CPU supports it.
+void fill_instance_transforms(
+    const instance_motion& motion,
+    float seconds,
+    std::span<mat4> transforms,
+    unsigned num_threads = 0,
+    simd_level level = simd_level::avx512);
+
+} // namespace icg
+
+#endif // ICG_INSTANCING_H
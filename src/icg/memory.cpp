@@ -0,0 +1,117 @@
+#include "memory.h"
+
+#if defined(__linux__)
+#include <fstream>
+#include <string>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace icg {
+
+#if defined(__linux__)
+
+namespace {
+
+// Reads a "<key>: <value> kB" line of /proc/self/status.
+std::size_t proc_status_kib(const std::string& key)
+{
+    auto status = std::ifstream{"/proc/self/status"};
+    auto line = std::string{};
+    while (std::getline(status, line)) {
+        if (line.starts_with(key) && line.size() > key.size() && line[key.size()] == ':') {
+            return std::stoull(line.substr(key.size() + 1));
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+std::size_t resident_bytes()
+{
+    return proc_status_kib("VmRSS") * 1024;
+}
+
+std::size_t peak_resident_bytes()
+{
+    return proc_status_kib("VmHWM") * 1024;
+}
+
+bool reset_peak_resident_bytes()
+{
+    auto clear_refs = std::ofstream{"/proc/self/clear_refs"};
+    clear_refs << "5";
+    return static_cast<bool>(clear_refs.flush());
+}
+
+#elif defined(__APPLE__)
+
+std::size_t resident_bytes()
+{
+    auto info = mach_task_basic_info_data_t{};
+    auto count = mach_msg_type_number_t{MACH_TASK_BASIC_INFO_COUNT};
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+}
+
+std::size_t peak_resident_bytes()
+{
+    auto usage = rusage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::size_t>(usage.ru_maxrss);
+}
+
+bool reset_peak_resident_bytes()
+{
+    return false;
+}
+
+#elif defined(_WIN32)
+
+std::size_t resident_bytes()
+{
+    auto counters = PROCESS_MEMORY_COUNTERS{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.WorkingSetSize;
+}
+
+std::size_t peak_resident_bytes()
+{
+    auto counters = PROCESS_MEMORY_COUNTERS{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+}
+
+bool reset_peak_resident_bytes()
+{
+    return false;
+}
+
+#else
+
+std::size_t resident_bytes()
+{
+    return 0;
+}
+
+std::size_t peak_resident_bytes()
+{
+    return 0;
+}
+
+bool reset_peak_resident_bytes()
+{
+    return false;
+}
+
+#endif
+
+} // namespace icg
@@ -0,0 +1,20 @@
+#ifndef ICG_MEMORY_H
+#define ICG_MEMORY_H
+
+#include <cstddef>
+
+namespace icg {
+
+// Resident set size of the process in bytes, 0 where unknown.
+std::size_t resident_bytes();
+
+// High-water mark of the resident set size in bytes, 0 where unknown.
+std::size_t peak_resident_bytes();
+
+// Restarts the high-water mark from the current resident set size, so the
+// peak of a single phase can be measured. Returns false where unsupported.
+bool reset_peak_resident_bytes();
+
+} // namespace icg
+
+#endif // ICG_MEMORY_H
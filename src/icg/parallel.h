@@ -0,0 +1,52 @@
+#ifndef ICG_PARALLEL_H
+#define ICG_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace icg {
+
+// Number of worker threads to use when the caller asks for 0 (meaning "all").
+inline unsigned resolve_num_threads(unsigned num_threads)
+{
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return num_threads;
+}
+
+// Calls f(i) for every i in [0, count) on up to `num_threads` threads.
+// Work items are handed out dynamically, so f must not depend on which thread
+// runs it.
+template <typename F>
+void parallel_for(std::size_t count, unsigned num_threads, F&& f)
+{
+    num_threads = static_cast<unsigned>(std::min<std::size_t>(resolve_num_threads(num_threads), count));
+    if (num_threads <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            f(i);
+        }
+        return;
+    }
+
+    auto next = std::atomic<std::size_t>{0};
+    auto worker = [&] {
+        for (auto i = next++; i < count; i = next++) {
+            f(i);
+        }
+    };
+
+    auto threads = std::vector<std::jthread>{};
+    threads.reserve(num_threads - 1);
+    for (unsigned t = 1; t < num_threads; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+}
+
+} // namespace icg
+
+#endif // ICG_PARALLEL_H
@@ -0,0 +1,139 @@
+#include "profiler.h"
+#include <fmt/core.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace icg {
+
+std::string_view name(frame_phase phase)
+{
+    switch (phase) {
+        case frame_phase::process_input:
+            return "process_input";
+        case frame_phase::draw:
+            return "draw";
+        case frame_phase::draw_ui:
+            return "draw_ui";
+        case frame_phase::gpu:
+            return "gpu";
+    }
+    return "unknown";
+}
+
+float frame_sample::cpu_ms() const
+{
+    auto sum = 0.0f;
+    for (auto phase : {frame_phase::process_input, frame_phase::draw, frame_phase::draw_ui}) {
+        sum += std::max(0.0f, duration_ms[static_cast<std::size_t>(phase)]);
+    }
+    return sum;
+}
+
+percentiles compute_percentiles(std::span<float> values)
+{
+    if (values.empty()) {
+        return {};
+    }
+    auto const at = [&](double q) {
+        auto const k = static_cast<std::size_t>(std::ceil(q * static_cast<double>(values.size()))) - 1;
+        auto const nth = values.begin() + static_cast<std::ptrdiff_t>(std::min(k, values.size() - 1));
+        std::ranges::nth_element(values, nth);
+        return *nth;
+    };
+    return {at(0.50), at(0.95), at(0.99)};
+}
+
+profiler::profiler(std::size_t capacity)
+    : ring(std::max<std::size_t>(1, capacity))
+{
+}
+
+void profiler::begin(frame_phase phase)
+{
+    if (current.duration_ms[static_cast<std::size_t>(phase)] >= 0.0f) {
+        publish();
+    }
+}
+
+void profiler::record(frame_phase phase, clock::time_point start, clock::time_point stop)
+{
+    begin(phase);
+    auto const p = static_cast<std::size_t>(phase);
+    current.start_us[p] = std::chrono::duration<double, std::micro>(start - origin).count();
+    current.duration_ms[p] = std::chrono::duration<float, std::milli>(stop - start).count();
+}
+
+void profiler::record_gpu(std::uint64_t frame, float milliseconds)
+{
+    auto const gpu = static_cast<std::size_t>(frame_phase::gpu);
+    if (frame == current.frame) {
+        current.duration_ms[gpu] = milliseconds;
+        current.start_us[gpu] = current.start_us[static_cast<std::size_t>(frame_phase::draw)];
+        return;
+    }
+    auto const count = published.load(std::memory_order_relaxed);
+    if (frame >= count || count - frame > ring.size()) {
+        return;
+    }
+    auto& sample = ring[frame % ring.size()];
+    sample.duration_ms[gpu] = milliseconds;
+    sample.start_us[gpu] = sample.start_us[static_cast<std::size_t>(frame_phase::draw)];
+}
+
+void profiler::publish()
+{
+    auto const frame = current.frame;
+    ring[frame % ring.size()] = current;
+    published.store(frame + 1, std::memory_order_release);
+    current = frame_sample{};
+    current.frame = frame + 1;
+}
+
+std::vector<frame_sample> profiler::latest(std::size_t count) const
+{
+    auto const end = published.load(std::memory_order_acquire);
+    count = std::min({count, static_cast<std::size_t>(end), ring.size()});
+    auto samples = std::vector<frame_sample>{};
+    samples.reserve(count);
+    for (auto frame = end - count; frame < end; ++frame) {
+        samples.push_back(ring[frame % ring.size()]);
+    }
+    return samples;
+}
+
+void profiler::write(const std::filesystem::path& path) const
+{
+    auto const samples = latest(ring.size());
+    auto file = std::ofstream{path};
+    if (path.extension() == ".json") {
+        // Chrome trace event format, one complete event per phase
+        file << "{\"traceEvents\":[";
+        auto first = true;
+        for (auto const& s : samples) {
+            for (std::size_t p = 0; p < num_frame_phases; ++p) {
+                if (s.duration_ms[p] < 0.0f) {
+                    continue;
+                }
+                file << (first ? "\n" : ",\n")
+                     << fmt::format(R"({{"name":"{}","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f},"args":{{"frame":{}}}}})",
+                            name(static_cast<frame_phase>(p)), p == static_cast<std::size_t>(frame_phase::gpu) ? 2 : 1,
+                            s.start_us[p], 1000.0 * s.duration_ms[p], s.frame);
+                first = false;
+            }
+        }
+        file << "\n]}\n";
+    } else {
+        file << "frame,process_input_ms,draw_ms,draw_ui_ms,gpu_ms,cpu_ms\n";
+        for (auto const& s : samples) {
+            file << fmt::format("{},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f}\n",
+                s.frame, s.duration_ms[0], s.duration_ms[1], s.duration_ms[2], s.duration_ms[3], s.cpu_ms());
+        }
+    }
+    if (!file) {
+        throw std::runtime_error{"Failed to write " + path.string()};
+    }
+}
+
+} // namespace icg
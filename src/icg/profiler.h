@@ -0,0 +1,120 @@
+#ifndef ICG_PROFILER_H
+#define ICG_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace icg {
+
+// Parts of a frame that are timed: the three CPU phases of the window loop
+// and the GPU time of the draw commands where timer queries are available.
+enum class frame_phase
+{
+    process_input,
+    draw,
+    draw_ui,
+    gpu
+};
+
+constexpr std::size_t num_frame_phases = 4;
+
+std::string_view name(frame_phase phase);
+
+// Start of each phase in microseconds since the profiler was created, and its
+// duration in milliseconds; phases that did not run have a negative duration.
+struct frame_sample
+{
+    std::uint64_t frame{0};
+    std::array<double, num_frame_phases> start_us{};
+    std::array<float, num_frame_phases> duration_ms{-1.0f, -1.0f, -1.0f, -1.0f};
+
+    // Sum of the CPU phases.
+    float cpu_ms() const;
+};
+
+struct percentiles
+{
+    float p50{0.0f};
+    float p95{0.0f};
+    float p99{0.0f};
+};
+
+// Percentiles of `values`, which it reorders.
+percentiles compute_percentiles(std::span<float> values);
+
+// Frame timings of the last `capacity` frames. Recording stores into a ring
+// allocated up front and publishes each finished frame with a single atomic
+// store, so it never locks or allocates on the render thread; readers take a
+// snapshot of the frames published so far.
+class profiler
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit profiler(std::size_t capacity = 1 << 16);
+
+    // Called as a phase begins. A phase that already ran in the current frame
+    // starts the next one, so frames are delimited however many of the phases
+    // the window loop runs.
+    void begin(frame_phase phase);
+
+    // Records a phase of the current frame.
+    void record(frame_phase phase, clock::time_point start, clock::time_point stop);
+
+    // GPU time of `frame`, which arrives a few frames late. Ignored if the
+    // frame is no longer kept.
+    void record_gpu(std::uint64_t frame, float milliseconds);
+
+    // Number of the frame being recorded.
+    std::uint64_t current_frame() const { return current.frame; }
+
+    // Up to `count` of the latest published frames, oldest first.
+    std::vector<frame_sample> latest(std::size_t count) const;
+
+    // Writes every kept frame as a Chrome trace (.json) or as CSV otherwise.
+    void write(const std::filesystem::path& path) const;
+
+private:
+    void publish();
+
+    clock::time_point origin{clock::now()};
+    std::vector<frame_sample> ring;
+    std::atomic<std::uint64_t> published{0};
+    frame_sample current;
+};
+
+// Adds the time from its construction to its destruction to a phase.
+class scoped_phase
+{
+public:
+    scoped_phase(profiler& p, frame_phase phase)
+        : p{p}
+        , phase{phase}
+    {
+        p.begin(phase);
+    }
+
+    scoped_phase(const scoped_phase&) = delete;
+    scoped_phase& operator=(const scoped_phase&) = delete;
+
+    ~scoped_phase()
+    {
+        p.record(phase, start, profiler::clock::now());
+    }
+
+private:
+    profiler& p;
+    frame_phase phase;
+    profiler::clock::time_point start{profiler::clock::now()};
+};
+
+} // namespace icg
+
+#endif // ICG_PROFILER_H
@@ -0,0 +1,143 @@
+#include "program_cache.h"
+#include <array>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <fstream>
+#include <random>
+#include <system_error>
+#include <utility>
+
+namespace icg {
+
+namespace {
+
+constexpr std::array<char, 8> magic = {'I', 'C', 'G', 'P', 'R', 'O', 'G', '\0'};
+constexpr std::uint32_t version = 1;
+
+struct header
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t format;
+    std::uint64_t key;
+    std::uint64_t size;
+    std::uint64_t checksum;
+};
+
+constexpr std::uint64_t fnv_offset = 0xcbf29ce484222325;
+constexpr std::uint64_t fnv_prime = 0x100000001b3;
+
+std::uint64_t fnv1a(std::span<const std::byte> bytes, std::uint64_t hash = fnv_offset)
+{
+    for (auto const b : bytes) {
+        hash = (hash ^ static_cast<std::uint64_t>(b)) * fnv_prime;
+    }
+    return hash;
+}
+
+std::uint64_t fnv1a(std::string_view text, std::uint64_t hash)
+{
+    // the length first, so that moving text between sources changes the key
+    auto const size = static_cast<std::uint64_t>(text.size());
+    hash = fnv1a(std::as_bytes(std::span{&size, 1}), hash);
+    return fnv1a(std::as_bytes(std::span{text}), hash);
+}
+
+} // namespace
+
+std::uint64_t program_cache_key(std::span<const std::string_view> sources, std::string_view driver)
+{
+    auto hash = fnv1a(driver, fnv_offset);
+    for (auto const source : sources) {
+        hash = fnv1a(source, hash);
+    }
+    return hash;
+}
+
+program_cache::program_cache(std::filesystem::path directory)
+    : root{std::move(directory)}
+{
+}
+
+std::filesystem::path program_cache::path(std::uint64_t key) const
+{
+    return root / fmt::format("{:016x}.bin", key);
+}
+
+std::optional<program_binary> program_cache::load(std::uint64_t key)
+{
+    auto file = std::ifstream{path(key), std::ios::binary};
+    if (!file) {
+        ++counts.misses;
+        return std::nullopt;
+    }
+
+    auto h = header{};
+    file.read(reinterpret_cast<char*>(&h), sizeof(h));
+    auto binary = program_binary{h.format, {}};
+    // the size is checked against the file before anything is allocated for it
+    auto error = std::error_code{};
+    auto const file_size = std::filesystem::file_size(path(key), error);
+    auto valid = file && !error && h.magic == magic && h.version == version && h.key == key
+        && file_size >= sizeof(h) && h.size == file_size - sizeof(h);
+    if (valid) {
+        binary.data.resize(h.size);
+        file.read(reinterpret_cast<char*>(binary.data.data()), static_cast<std::streamsize>(h.size));
+        valid = file && file.peek() == std::ifstream::traits_type::eof() && fnv1a(binary.data) == h.checksum;
+    }
+    if (!valid) {
+        ++counts.rejected;
+        ++counts.misses;
+        return std::nullopt;
+    }
+    ++counts.hits;
+    return binary;
+}
+
+bool program_cache::store(std::uint64_t key, const program_binary& binary)
+{
+    auto error = std::error_code{};
+    std::filesystem::create_directories(root, error);
+    if (error) {
+        return false;
+    }
+
+    auto const target = path(key);
+    auto temporary = target;
+    temporary += fmt::format(".{:08x}.tmp", std::random_device{}());
+    {
+        auto file = std::ofstream{temporary, std::ios::binary | std::ios::trunc};
+        auto const h = header{magic, version, binary.format, key, binary.data.size(), fnv1a(binary.data)};
+        file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        file.write(reinterpret_cast<const char*>(binary.data.data()), static_cast<std::streamsize>(binary.data.size()));
+        if (!file) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(temporary, target, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+std::filesystem::path default_program_cache_directory()
+{
+    if (auto const xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg != '\0') {
+        return std::filesystem::path{xdg} / "icg" / "programs";
+    }
+    if (auto const home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+        return std::filesystem::path{home} / ".cache" / "icg" / "programs";
+    }
+    return std::filesystem::temp_directory_path() / "icg" / "programs";
+}
+
+program_cache& default_program_cache()
+{
+    static auto cache = program_cache{default_program_cache_directory()};
+    return cache;
+}
+
+} // namespace icg
@@ -0,0 +1,80 @@
+#ifndef ICG_PROGRAM_CACHE_H
+#define ICG_PROGRAM_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace icg {
+
+// Key of a linked program: a hash of the source of each of its shaders and of
+// the driver, e.g. its vendor, renderer and version strings, since binaries
+// are only valid for the driver that produced them.
+std::uint64_t program_cache_key(std::span<const std::string_view> sources, std::string_view driver);
+
+// Linked program as glGetProgramBinary returns it.
+struct program_binary
+{
+    std::uint32_t format{0};
+    std::vector<std::byte> data;
+};
+
+// Hits and misses of a program_cache. A rejected entry was found but did not
+// validate, or was refused by the driver, and counts as a miss as well.
+struct program_cache_stats
+{
+    std::size_t hits{0};
+    std::size_t misses{0};
+    std::size_t rejected{0};
+};
+
+// Directory of program binaries, one file per key with a header holding the
+// key, the binary format, the size and a checksum of the binary, so that a
+// stale, truncated or corrupt entry is detected and ignored. Entries are
+// written to a temporary file first and renamed into place, so that demos
+// starting at the same time never read a partial one.
+class program_cache
+{
+public:
+    explicit program_cache(std::filesystem::path directory);
+
+    // The binary stored under `key`, if any is there and valid.
+    std::optional<program_binary> load(std::uint64_t key);
+
+    // Stores `binary` under `key`. Failing to write the cache is not an error
+    // for the caller, which has the program already, so it only returns false.
+    bool store(std::uint64_t key, const program_binary& binary);
+
+    // Counts an entry that loaded but was refused by the driver: load()
+    // counted it as a hit, which it turned out not to be.
+    void reject()
+    {
+        --counts.hits;
+        ++counts.misses;
+        ++counts.rejected;
+    }
+
+    const std::filesystem::path& directory() const { return root; }
+    const program_cache_stats& stats() const { return counts; }
+
+private:
+    std::filesystem::path path(std::uint64_t key) const;
+
+    std::filesystem::path root;
+    program_cache_stats counts;
+};
+
+// $XDG_CACHE_HOME/icg/programs, falling back to ~/.cache and then to the
+// temporary directory.
+std::filesystem::path default_program_cache_directory();
+
+// Cache every demo shares, in default_program_cache_directory().
+program_cache& default_program_cache();
+
+} // namespace icg
+
+#endif // ICG_PROGRAM_CACHE_H
@@ -0,0 +1,79 @@
+#include "progressive_chaos_game.h"
+#include <utility>
+
+namespace icg {
+
+namespace {
+
+// How long the worker sleeps while all chunks are waiting to be consumed,
+// short against a frame.
+constexpr auto full_queue_wait = std::chrono::microseconds{500};
+
+} // namespace
+
+template <typename Vec, std::size_t N>
+progressive_chaos_game<Vec, N>::progressive_chaos_game(
+    const std::array<Vec, N>& vertices,
+    std::size_t num_positions,
+    std::uint32_t seed,
+    std::size_t chunk_size,
+    unsigned num_threads,
+    simd_level level)
+    : num_positions{num_positions}
+{
+    auto stream = chaos_game_stream<Vec, N>{vertices, num_positions, seed, chunk_size, num_threads, level};
+    worker = std::jthread{[this, chunk_size](std::stop_token stop, chaos_game_stream<Vec, N> s) {
+        work(stop, std::move(s), chunk_size);
+    }, stream};
+}
+
+template <typename Vec, std::size_t N>
+progressive_chaos_game<Vec, N>::~progressive_chaos_game()
+{
+    worker.request_stop();
+}
+
+template <typename Vec, std::size_t N>
+void progressive_chaos_game<Vec, N>::work(std::stop_token stop, chaos_game_stream<Vec, N> stream, std::size_t chunk_size)
+{
+    auto allocated = std::size_t{0};
+    for (auto count = stream.next_chunk_size(); count > 0 && !stop.stop_requested(); count = stream.next_chunk_size()) {
+        auto points = std::vector<Vec>{};
+        if (allocated < progressive_chunks_in_flight) {
+            points.resize(std::max(count, chunk_size));
+            ++allocated;
+        } else {
+            // every chunk is allocated, wait for the consumer to return one
+            auto recycled = free.try_pop();
+            while (!recycled && !stop.stop_requested()) {
+                std::this_thread::sleep_for(full_queue_wait);
+                recycled = free.try_pop();
+            }
+            if (!recycled) {
+                return;
+            }
+            points = std::move(*recycled);
+        }
+
+        auto const first = stream.position();
+        stream.generate(points);
+        // cannot fail, there are no more chunks than slots
+        ready.try_push(chunk{first, count, std::move(points)});
+    }
+}
+
+template <typename Vec, std::size_t N>
+void progressive_chaos_game<Vec, N>::consumed(std::size_t count)
+{
+    auto const seconds = std::chrono::duration<double>(clock::now() - start).count();
+    if (counts.points == 0) {
+        counts.first_chunk_seconds = seconds;
+    }
+    counts.points += count;
+    counts.seconds = seconds;
+}
+
+template class progressive_chaos_game<vec2, 3>;
+template class progressive_chaos_game<vec3, 4>;
+
+} // namespace icg
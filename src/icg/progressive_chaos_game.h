@@ -0,0 +1,113 @@
+#ifndef ICG_PROGRESSIVE_CHAOS_GAME_H
+#define ICG_PROGRESSIVE_CHAOS_GAME_H
+
+#include "chaos_game.h"
+#include "spsc_queue.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace icg {
+
+// Points per chunk of a progressive_chaos_game by default: 16 chains, small
+// enough for a chunk to be generated and uploaded within a frame.
+constexpr std::size_t progressive_chunk_size = 16 * chaos_game_chain_length;
+
+// Chunks generated ahead of the consumer at most, which bounds the memory a
+// progressive_chaos_game holds to this many chunks.
+constexpr std::size_t progressive_chunks_in_flight = 4;
+
+// How fast a progressive_chaos_game delivered its points, measured when they
+// were consumed: the time until the first chunk and until the last one.
+struct progressive_stats
+{
+    std::size_t points{0};
+    double first_chunk_seconds{0.0};
+    double seconds{0.0};
+
+    double fill_rate() const { return seconds > 0.0 ? static_cast<double>(points) / seconds : 0.0; }
+};
+
+// chaos_game_stream run on a worker thread, so that a window can draw the
+// points generated so far instead of waiting for all of them. Chunks are
+// handed over through an spsc_queue and their storage returned through
+// another, so after the first few chunks nothing is allocated. Consumed in
+// order, the chunks are identical to the output of parallel_chaos_game.
+template <typename Vec, std::size_t N>
+class progressive_chaos_game
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    progressive_chaos_game(
+        const std::array<Vec, N>& vertices,
+        std::size_t num_positions,
+        std::uint32_t seed,
+        std::size_t chunk_size = progressive_chunk_size,
+        unsigned num_threads = 0,
+        simd_level level = simd_level::avx512);
+
+    progressive_chaos_game(const progressive_chaos_game&) = delete;
+    progressive_chaos_game& operator=(const progressive_chaos_game&) = delete;
+
+    // Stops the worker after the chunk it is generating.
+    ~progressive_chaos_game();
+
+    // Hands the chunks that are ready to upload(first, points) in order, as
+    // long as `budget` is not used up; the first one ready is always handed
+    // out. Returns the number of points handed out.
+    template <typename Upload>
+    std::size_t consume(clock::duration budget, Upload&& upload)
+    {
+        auto const start = clock::now();
+        auto count = std::size_t{0};
+        while (count == 0 || clock::now() - start < budget) {
+            auto c = ready.try_pop();
+            if (!c) {
+                break;
+            }
+            upload(c->first, std::span<const Vec>{c->points}.first(c->count));
+            count += c->count;
+            consumed(c->count);
+            free.try_push(std::move(c->points));
+        }
+        return count;
+    }
+
+    // Points handed out so far; [0, consumed_size()) are ready to draw.
+    std::size_t consumed_size() const { return counts.points; }
+    std::size_t size() const { return num_positions; }
+    bool done() const { return counts.points == num_positions; }
+
+    const progressive_stats& stats() const { return counts; }
+
+private:
+    struct chunk
+    {
+        std::size_t first{0};
+        std::size_t count{0};
+        std::vector<Vec> points;
+    };
+
+    void work(std::stop_token stop, chaos_game_stream<Vec, N> stream, std::size_t chunk_size);
+    void consumed(std::size_t count);
+
+    std::size_t num_positions;
+    spsc_queue<chunk> ready{progressive_chunks_in_flight};
+    spsc_queue<std::vector<Vec>> free{progressive_chunks_in_flight};
+    clock::time_point start{clock::now()};
+    progressive_stats counts;
+    // last, so that it stops before the queues go away
+    std::jthread worker;
+};
+
+extern template class progressive_chaos_game<vec2, 3>;
+extern template class progressive_chaos_game<vec3, 4>;
+
+} // namespace icg
+
+#endif // ICG_PROGRESSIVE_CHAOS_GAME_H
@@ -0,0 +1,69 @@
+#ifndef ICG_RANDOM_H
+#define ICG_RANDOM_H
+
+#include <cstdint>
+
+namespace icg {
+
+// Counter-based random number generator: the n-th number of a stream is a pure
+// function of the stream key and n, so independent streams can be generated
+// in any order, on any thread, and only with 32-bit integer operations, which
+// keeps the same sequence reproducible in SIMD lanes and in shaders.
+//
+// A number is a position on a Weyl sequence, hashed by the murmur3 finalizer,
+// keyed again and hashed by a second round. The streams of one seed start
+// stream_spacing positions apart, so the first 2^32 / stream_spacing of them
+// use disjoint stretches of the sequence for that many numbers each. The
+// second round keeps streams apart beyond that too: streams whose stretches
+// overlap still hash the same positions with different keys, rather than
+// repeating each other's numbers shifted in time.
+struct counter_rng
+{
+    // Numbers each stream of a seed draws before it reaches the start of the
+    // next one.
+    static constexpr std::uint32_t stream_spacing = 66'560;
+
+    // Inverse of the Weyl increment modulo 2^32, mapping a key back to its
+    // position on the sequence.
+    static constexpr std::uint32_t weyl_inverse = 0x144cbc89u;
+
+    std::uint32_t key;
+
+    // Derives the key of stream `stream` of the generator seeded with `seed`.
+    static constexpr counter_rng stream(std::uint32_t seed, std::uint64_t stream)
+    {
+        // splitmix64 finalizer for where the streams of the seed start
+        auto z = (static_cast<std::uint64_t>(seed) << 32) + 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        z = z ^ (z >> 31);
+        auto const position = static_cast<std::uint32_t>(z ^ (z >> 32)) + static_cast<std::uint32_t>(stream) * stream_spacing;
+        return counter_rng{position * 0x9e3779b9u};
+    }
+
+    // Position of the first number of the stream on the Weyl sequence.
+    constexpr std::uint32_t position() const { return key * weyl_inverse; }
+
+    constexpr std::uint32_t operator()(std::uint32_t counter) const
+    {
+        // Weyl sequence scrambled by the murmur3 finalizer
+        auto x = counter * 0x9e3779b9u + key;
+        x = (x ^ (x >> 16)) * 0x85ebca6bu;
+        x = (x ^ (x >> 13)) * 0xc2b2ae35u;
+        x ^= (x >> 16) ^ key;
+        // keyed again and scrambled by the lowbias32 finalizer
+        x = (x ^ (x >> 16)) * 0x7feb352du;
+        x = (x ^ (x >> 15)) * 0x846ca68bu;
+        return x ^ (x >> 16);
+    }
+};
+
+// Maps a random number to [0, n) for n <= 2^16 using only 32-bit arithmetic.
+constexpr std::uint32_t uniform_index(std::uint32_t random, std::uint32_t n)
+{
+    return ((random >> 16) * n) >> 16;
+}
+
+} // namespace icg
+
+#endif // ICG_RANDOM_H
@@ -0,0 +1,41 @@
+#ifndef ICG_RANDOM_KERNELS_H
+#define ICG_RANDOM_KERNELS_H
+
+#include "random.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+
+namespace icg::detail {
+
+// counter_rng lane by lane, from the Weyl term counter * 0x9e3779b9 shared by
+// all lanes and the key of each lane.
+__attribute__((target("avx2")))
+inline __m256i counter_rng_avx2(__m256i weyl, __m256i key)
+{
+    auto x = _mm256_add_epi32(weyl, key);
+    x = _mm256_mullo_epi32(_mm256_xor_si256(x, _mm256_srli_epi32(x, 16)), _mm256_set1_epi32(static_cast<int>(0x85ebca6bu)));
+    x = _mm256_mullo_epi32(_mm256_xor_si256(x, _mm256_srli_epi32(x, 13)), _mm256_set1_epi32(static_cast<int>(0xc2b2ae35u)));
+    x = _mm256_xor_si256(x, _mm256_xor_si256(_mm256_srli_epi32(x, 16), key));
+    x = _mm256_mullo_epi32(_mm256_xor_si256(x, _mm256_srli_epi32(x, 16)), _mm256_set1_epi32(static_cast<int>(0x7feb352du)));
+    x = _mm256_mullo_epi32(_mm256_xor_si256(x, _mm256_srli_epi32(x, 15)), _mm256_set1_epi32(static_cast<int>(0x846ca68bu)));
+    return _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+}
+
+__attribute__((target("avx512f")))
+inline __m512i counter_rng_avx512(__m512i weyl, __m512i key)
+{
+    auto x = _mm512_add_epi32(weyl, key);
+    x = _mm512_mullo_epi32(_mm512_xor_si512(x, _mm512_srli_epi32(x, 16)), _mm512_set1_epi32(static_cast<int>(0x85ebca6bu)));
+    x = _mm512_mullo_epi32(_mm512_xor_si512(x, _mm512_srli_epi32(x, 13)), _mm512_set1_epi32(static_cast<int>(0xc2b2ae35u)));
+    x = _mm512_xor_si512(x, _mm512_xor_si512(_mm512_srli_epi32(x, 16), key));
+    x = _mm512_mullo_epi32(_mm512_xor_si512(x, _mm512_srli_epi32(x, 16)), _mm512_set1_epi32(static_cast<int>(0x7feb352du)));
+    x = _mm512_mullo_epi32(_mm512_xor_si512(x, _mm512_srli_epi32(x, 15)), _mm512_set1_epi32(static_cast<int>(0x846ca68bu)));
+    return _mm512_xor_si512(x, _mm512_srli_epi32(x, 16));
+}
+
+} // namespace icg::detail
+
+#endif
+
+#endif // ICG_RANDOM_KERNELS_H
@@ -0,0 +1,83 @@
+#include "render_options.h"
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace icg {
+
+namespace {
+
+constexpr auto usage = "usage: [--frames N] [--size WIDTHxHEIGHT] [--output DIRECTORY] [--profile FILE] [--fixed-step SECONDS] [--uncapped] [--record FILE] [--replay FILE] [--replay-fast] [--shader-dir DIRECTORY]";
+
+// Offscreen runs step animations at 60 Hz unless --fixed-step says otherwise.
+constexpr double offscreen_fixed_step = 1.0 / 60.0;
+
+template <typename T>
+T parse_number(std::string_view text)
+{
+    auto value = T{};
+    auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || end != text.data() + text.size()) {
+        throw std::invalid_argument{"Not a number: " + std::string{text} + "\n" + usage};
+    }
+    return value;
+}
+
+} // namespace
+
+render_options parse_render_options(int argc, const char* const argv[])
+{
+    auto options = render_options{};
+    for (int i = 1; i < argc; ++i) {
+        auto const arg = std::string_view{argv[i]};
+        if (arg == "--uncapped") {
+            options.vsync = false;
+            continue;
+        }
+        if (arg == "--replay-fast") {
+            options.replay_fast = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument{"Missing value of " + std::string{arg} + "\n" + usage};
+        }
+        auto const value = std::string_view{argv[++i]};
+        if (arg == "--frames") {
+            options.frames = parse_number<std::size_t>(value);
+        } else if (arg == "--size") {
+            auto const x = value.find('x');
+            if (x == std::string_view::npos) {
+                throw std::invalid_argument{"Size is not WIDTHxHEIGHT: " + std::string{value} + "\n" + usage};
+            }
+            options.width = parse_number<int>(value.substr(0, x));
+            options.height = parse_number<int>(value.substr(x + 1));
+            if (options.width <= 0 || options.height <= 0) {
+                throw std::invalid_argument{"Size must be positive: " + std::string{value} + "\n" + usage};
+            }
+        } else if (arg == "--output") {
+            options.output = value;
+        } else if (arg == "--profile") {
+            options.profile = value;
+        } else if (arg == "--record") {
+            options.record = value;
+        } else if (arg == "--replay") {
+            options.replay = value;
+        } else if (arg == "--shader-dir") {
+            options.shader_directory = value;
+        } else if (arg == "--fixed-step") {
+            options.fixed_step = parse_number<double>(value);
+            if (!(options.fixed_step > 0.0)) {
+                throw std::invalid_argument{"Fixed step must be positive: " + std::string{value} + "\n" + usage};
+            }
+        } else {
+            throw std::invalid_argument{"Unknown option " + std::string{arg} + "\n" + usage};
+        }
+    }
+    if (options.offscreen() && options.fixed_step == 0.0) {
+        options.fixed_step = offscreen_fixed_step;
+    }
+    return options;
+}
+
+} // namespace icg
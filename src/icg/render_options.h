@@ -0,0 +1,48 @@
+#ifndef ICG_RENDER_OPTIONS_H
+#define ICG_RENDER_OPTIONS_H
+
+#include <cstddef>
+#include <filesystem>
+
+namespace icg {
+
+// Command line of a demo. With --frames N the demo renders N frames offscreen
+// and writes them to disk instead of opening an interactive window. With
+// --profile the frame timings are written to FILE on exit, as a Chrome trace
+// if it ends in .json and as CSV otherwise. --fixed-step makes animations
+// advance by SECONDS every frame instead of by the real time between frames,
+// which offscreen runs do at 60 Hz unless told otherwise, and --uncapped turns
+// vsync off to measure throughput. --record writes the input of the demo to
+// FILE and --replay feeds it back from FILE instead of the window, at the
+// speed it was recorded at or, with --replay-fast, a recorded frame per frame.
+// --shader-dir reads shaders from DIRECTORY instead of the sources embedded at
+// build time, to edit them without rebuilding:
+//
+//     <demo> [--frames N] [--size WIDTHxHEIGHT] [--output DIRECTORY]
+//            [--profile FILE] [--fixed-step SECONDS] [--uncapped]
+//            [--record FILE] [--replay FILE] [--replay-fast]
+//            [--shader-dir DIRECTORY]
+struct render_options
+{
+    std::size_t frames{0};
+    int width{512};
+    int height{512};
+    std::filesystem::path output{"frames"};
+    std::filesystem::path profile;
+    double fixed_step{0.0};
+    bool vsync{true};
+    std::filesystem::path record;
+    std::filesystem::path replay;
+    bool replay_fast{false};
+    std::filesystem::path shader_directory;
+
+    bool offscreen() const { return frames > 0; }
+};
+
+// Throws std::invalid_argument, with the usage in its message, on anything
+// it does not understand.
+render_options parse_render_options(int argc, const char* const argv[]);
+
+} // namespace icg
+
+#endif // ICG_RENDER_OPTIONS_H
@@ -0,0 +1,128 @@
+#include "shader_source.h"
+#include <fmt/core.h>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace icg {
+
+namespace {
+
+// Deeper than any sensible include hierarchy, so only a cycle gets here.
+constexpr int max_include_depth = 32;
+
+std::string read_file(const std::filesystem::path& path)
+{
+    auto file = std::ifstream{path, std::ios::binary};
+    if (!file) {
+        throw std::runtime_error{"Cannot read shader " + path.string()};
+    }
+    return {std::istreambuf_iterator<char>{file}, {}};
+}
+
+std::string_view trim_start(std::string_view s)
+{
+    auto const first = s.find_first_not_of(" \t");
+    return first == std::string_view::npos ? std::string_view{} : s.substr(first);
+}
+
+// The file name of an #include "file" line, if it is one.
+std::optional<std::string_view> included_file(std::string_view line)
+{
+    line = trim_start(line);
+    if (!line.starts_with('#')) {
+        return std::nullopt;
+    }
+    line = trim_start(line.substr(1));
+    if (!line.starts_with("include")) {
+        return std::nullopt;
+    }
+    line = trim_start(line.substr(7));
+    auto const close = line.find('"', 1);
+    if (!line.starts_with('"') || close == std::string_view::npos) {
+        throw std::runtime_error{"Malformed shader #include: " + std::string{line}};
+    }
+    return line.substr(1, close - 1);
+}
+
+std::string define(const shader_define& d)
+{
+    return d.value.empty() ? fmt::format("#define {}\n", d.name) : fmt::format("#define {} {}\n", d.name, d.value);
+}
+
+void preprocess(std::string& out, std::string_view source, const std::filesystem::path& directory, std::span<const shader_define> defines, int depth)
+{
+    auto defined = defines.empty();
+    auto number = 0;
+    while (!source.empty()) {
+        auto const end = source.find('\n');
+        auto const line = source.substr(0, end);
+        source = end == std::string_view::npos ? std::string_view{} : source.substr(end + 1);
+        ++number;
+
+        if (!defined && !trim_start(line).starts_with("#version")) {
+            // no #version line, which must come first, so define right away
+            for (auto const& d : defines) {
+                out += define(d);
+            }
+            out += fmt::format("#line {}\n", number);
+            defined = true;
+        }
+
+        if (auto const file = included_file(line)) {
+            auto const path = directory / *file;
+            if (depth == max_include_depth) {
+                throw std::runtime_error{"Shader includes nest too deeply at " + path.string()};
+            }
+            out += "#line 1\n";
+            preprocess(out, read_file(path), path.parent_path(), {}, depth + 1);
+            out += fmt::format("#line {}\n", number + 1);
+            continue;
+        }
+        out += line;
+        out += '\n';
+
+        if (!defined) {
+            for (auto const& d : defines) {
+                out += define(d);
+            }
+            out += fmt::format("#line {}\n", number + 1);
+            defined = true;
+        }
+    }
+}
+
+std::filesystem::path& shader_directory()
+{
+    static auto directory = std::filesystem::path{};
+    return directory;
+}
+
+} // namespace
+
+std::string preprocess_shader(std::string_view source, const std::filesystem::path& directory, std::span<const shader_define> defines)
+{
+    auto out = std::string{};
+    out.reserve(source.size());
+    preprocess(out, source, directory, defines, 0);
+    return out;
+}
+
+std::string preprocess_shader_file(const std::filesystem::path& path, std::span<const shader_define> defines)
+{
+    return preprocess_shader(read_file(path), path.parent_path(), defines);
+}
+
+void set_default_shader_directory(std::filesystem::path directory)
+{
+    shader_directory() = std::move(directory);
+}
+
+const std::filesystem::path& default_shader_directory()
+{
+    return shader_directory();
+}
+
+} // namespace icg
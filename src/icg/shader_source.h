@@ -0,0 +1,45 @@
+#ifndef ICG_SHADER_SOURCE_H
+#define ICG_SHADER_SOURCE_H
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace icg {
+
+// Source of a shader compiled into the executable by the embed_shaders build
+// step, under the file name it was embedded from.
+struct shader_source
+{
+    std::string_view name;
+    std::string_view text;
+};
+
+// Macro defined at the top of a preprocessed shader; an empty value defines
+// it without one.
+struct shader_define
+{
+    std::string name;
+    std::string value;
+};
+
+// Resolves the #include "file" directives of `source`, relative to
+// `directory` and recursively, and defines `defines` right after its #version
+// line. #line directives keep the line numbers of compile errors those of the
+// file they are in. Throws std::runtime_error if an included file cannot be
+// read or includes nest too deeply, e.g. because a file includes itself.
+std::string preprocess_shader(std::string_view source, const std::filesystem::path& directory, std::span<const shader_define> defines = {});
+
+// preprocess_shader of the contents of `path`.
+std::string preprocess_shader_file(const std::filesystem::path& path, std::span<const shader_define> defines = {});
+
+// Directory shaders are read from instead of their embedded sources, for
+// editing them without rebuilding; empty (the default) means embedded. Set
+// once at startup.
+void set_default_shader_directory(std::filesystem::path directory);
+const std::filesystem::path& default_shader_directory();
+
+} // namespace icg
+
+#endif // ICG_SHADER_SOURCE_H
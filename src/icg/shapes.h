@@ -0,0 +1,34 @@
+#ifndef ICG_SHAPES_H
+#define ICG_SHAPES_H
+
+#include "vector.h"
+#include <array>
+
+namespace icg {
+
+// Corners of the 2D gasket used by 02/gasket1 and 02/gasket2.
+constexpr auto gasket_triangle = std::array {
+    vec2{-1.0f, -1.0f},
+    vec2{ 0.0f,  1.0f},
+    vec2{ 1.0f, -1.0f}
+};
+
+// Vertices of the 3D gasket used by 02/gasket3 and 02/gasket3v2.
+constexpr auto gasket_tetrahedron = std::array {
+    vec3{-0.5f, -0.5f, -0.5f},
+    vec3{ 0.5f, -0.5f, -0.5f},
+    vec3{ 0.0f,  0.5f,  0.0f},
+    vec3{ 0.0f, -0.5f,  0.5f}
+};
+
+// Corners of the subdivided 3D gasket used by 02/gasket4.
+constexpr auto gasket_regular_tetrahedron = std::array {
+    vec3{ 0.0000f,  0.0000f, -1.0000f},
+    vec3{ 0.0000f,  0.9428f,  0.3333f},
+    vec3{-0.8165f, -0.4714f,  0.3333f},
+    vec3{ 0.8165f, -0.4714f,  0.3333f}
+};
+
+} // namespace icg
+
+#endif // ICG_SHAPES_H
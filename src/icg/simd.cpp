@@ -0,0 +1,43 @@
+#include "simd.h"
+#include <algorithm>
+
+namespace icg {
+
+simd_level detect_simd_level()
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    static auto const level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return simd_level::avx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return simd_level::avx2;
+        }
+        return simd_level::scalar;
+    }();
+    return level;
+#else
+    return simd_level::scalar;
+#endif
+}
+
+simd_level supported_simd_level(simd_level requested)
+{
+    return std::min(requested, detect_simd_level());
+}
+
+std::string_view name(simd_level level)
+{
+    switch (level) {
+        case simd_level::scalar:
+            return "scalar";
+        case simd_level::avx2:
+            return "avx2";
+        case simd_level::avx512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+} // namespace icg
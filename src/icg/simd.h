@@ -0,0 +1,28 @@
+#ifndef ICG_SIMD_H
+#define ICG_SIMD_H
+
+#include <string_view>
+
+namespace icg {
+
+// Instruction sets the vectorized kernels are compiled for. All of them are
+// built into the same binary and picked at run time, so it still runs on
+// machines without AVX2.
+enum class simd_level
+{
+    scalar,
+    avx2,
+    avx512
+};
+
+// Best level supported by the CPU the program runs on.
+simd_level detect_simd_level();
+
+// The lower of `requested` and what the CPU supports.
+simd_level supported_simd_level(simd_level requested);
+
+std::string_view name(simd_level level);
+
+} // namespace icg
+
+#endif // ICG_SIMD_H
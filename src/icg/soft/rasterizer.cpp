@@ -0,0 +1,372 @@
+#include "rasterizer.h"
+#include <icg/parallel.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace icg::soft {
+
+namespace {
+
+// Vertices shaded per work item.
+constexpr std::size_t vertex_block_size = 4096;
+
+// Vertex in window coordinates, with 1/w and color/w kept for perspective
+// correct interpolation. Vertices behind the eye are marked clipped, and
+// triangles with any of them are clipped by clip_triangle before binning.
+struct window_vertex
+{
+    float x;
+    float y;
+    float z;
+    float inv_w;
+    vec4 color;
+    bool clipped;
+};
+
+window_vertex to_window(const vertex_output& v, int width, int height)
+{
+    auto const w = v.position.w;
+    if (!(w > 0.0f)) {
+        return {0.0f, 0.0f, 0.0f, 0.0f, {}, true};
+    }
+    auto const inv_w = 1.0f / w;
+    return {
+        (v.position.x * inv_w + 1.0f) * 0.5f * static_cast<float>(width),
+        (v.position.y * inv_w + 1.0f) * 0.5f * static_cast<float>(height),
+        (v.position.z * inv_w + 1.0f) * 0.5f,
+        inv_w,
+        {v.color.x * inv_w, v.color.y * inv_w, v.color.z * inv_w, v.color.w * inv_w},
+        false
+    };
+}
+
+// Smallest w a clipped triangle keeps, so that 1/w stays finite.
+constexpr float min_w = 1e-5f;
+
+vertex_output lerp(const vertex_output& a, const vertex_output& b, float t)
+{
+    auto const mix = [t](const vec4& u, const vec4& v) {
+        return vec4{u.x + t * (v.x - u.x), u.y + t * (v.y - u.y), u.z + t * (v.z - u.z), u.w + t * (v.w - u.w)};
+    };
+    return {mix(a.position, b.position), mix(a.color, b.color)};
+}
+
+// Clips triangle (a, b, c) in clip space against the near plane z = -w and
+// against w = min_w, as OpenGL does before the perspective division, and
+// appends the triangles of what is left as a fan of window vertices to `out`.
+void clip_triangle(const vertex_output& a, const vertex_output& b, const vertex_output& c, int width, int height, std::vector<window_vertex>& out)
+{
+    // each plane adds at most one vertex
+    auto polygon = std::array<vertex_output, 5>{a, b, c};
+    auto size = std::size_t{3};
+    auto const clip = [&](auto distance) {
+        auto clipped = std::array<vertex_output, 5>{};
+        auto n = std::size_t{0};
+        for (std::size_t i = 0; i < size; ++i) {
+            auto const& u = polygon[i];
+            auto const& v = polygon[(i + 1) % size];
+            auto const du = distance(u.position);
+            auto const dv = distance(v.position);
+            if (du >= 0.0f) {
+                clipped[n++] = u;
+            }
+            if ((du >= 0.0f) != (dv >= 0.0f)) {
+                clipped[n++] = lerp(u, v, du / (du - dv));
+            }
+        }
+        polygon = clipped;
+        size = n;
+    };
+    clip([](const vec4& p) { return p.z + p.w; });
+    clip([](const vec4& p) { return p.w - min_w; });
+
+    for (std::size_t i = 1; i + 1 < size; ++i) {
+        for (auto v : {polygon[0], polygon[i], polygon[i + 1]}) {
+            // a vertex cut at w = min_w may round below it
+            v.position.w = std::max(v.position.w, min_w);
+            out.push_back(to_window(v, width, height));
+        }
+    }
+}
+
+std::vector<window_vertex> shade_vertices(const framebuffer& target, const state& state, std::size_t first, std::size_t count, const vertex_shader& vs)
+{
+    auto vertices = std::vector<window_vertex>(count);
+    auto const num_blocks = (count + vertex_block_size - 1) / vertex_block_size;
+    parallel_for(num_blocks, state.num_threads, [&](std::size_t block) {
+        auto const begin = block * vertex_block_size;
+        auto const end = std::min(begin + vertex_block_size, count);
+        for (auto i = begin; i < end; ++i) {
+            vertices[i] = to_window(vs(first + i), target.width, target.height);
+        }
+    });
+    return vertices;
+}
+
+// Splits a strip or fan of `count` vertices into triangles, the vertices
+// of each listed as positions in the draw.
+std::vector<std::uint32_t> assemble(primitive mode, std::size_t count)
+{
+    auto triangles = std::vector<std::uint32_t>{};
+    auto const n = static_cast<std::uint32_t>(count);
+    switch (mode) {
+        case primitive::points:
+            for (std::uint32_t i = 0; i < n; ++i) {
+                triangles.push_back(i);
+            }
+            break;
+        case primitive::triangles:
+            for (std::uint32_t i = 0; i + 3 <= n; i += 3) {
+                triangles.insert(triangles.end(), {i, i + 1, i + 2});
+            }
+            break;
+        case primitive::triangle_strip:
+            // every other triangle swaps its first two vertices to keep the
+            // winding of the strip
+            for (std::uint32_t i = 0; i + 3 <= n; ++i) {
+                if (i % 2 == 0) {
+                    triangles.insert(triangles.end(), {i, i + 1, i + 2});
+                } else {
+                    triangles.insert(triangles.end(), {i + 1, i, i + 2});
+                }
+            }
+            break;
+        case primitive::triangle_fan:
+            for (std::uint32_t i = 1; i + 2 <= n; ++i) {
+                triangles.insert(triangles.end(), {0, i, i + 1});
+            }
+            break;
+    }
+    return triangles;
+}
+
+struct tile_grid
+{
+    int columns;
+    int rows;
+
+    std::size_t size() const { return static_cast<std::size_t>(columns) * static_cast<std::size_t>(rows); }
+};
+
+// Twice the signed area of (a, b, p), positive when p lies to the left of
+// the directed edge a -> b.
+float edge(float ax, float ay, float bx, float by, float px, float py)
+{
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+// Whether pixel centers exactly on the edge a -> b of a counterclockwise
+// triangle belong to it (the top-left rule), so that pixels on an edge shared
+// by two triangles are drawn once.
+bool top_left(const window_vertex& a, const window_vertex& b)
+{
+    return (a.y == b.y && b.x < a.x) || b.y < a.y;
+}
+
+void write_fragment(framebuffer& target, const state& state, std::size_t pixel, float z, const vec4& color, const fragment_shader& fs)
+{
+    if (z < 0.0f || z > 1.0f) {
+        return;
+    }
+    if (state.depth_test) {
+        if (!(z < target.depth[pixel])) {
+            return;
+        }
+        target.depth[pixel] = z;
+    }
+    target.color[pixel] = pack_rgba8(fs ? fs(color) : color);
+}
+
+void rasterize_point(framebuffer& target, const state& state, const window_vertex& v, int x0, int y0, int x1, int y1, const fragment_shader& fs)
+{
+    auto const x = static_cast<int>(std::floor(v.x));
+    auto const y = static_cast<int>(std::floor(v.y));
+    if (x < x0 || x >= x1 || y < y0 || y >= y1) {
+        return;
+    }
+    auto const w = 1.0f / v.inv_w;
+    auto const pixel = static_cast<std::size_t>(y) * static_cast<std::size_t>(target.width) + static_cast<std::size_t>(x);
+    write_fragment(target, state, pixel, v.z, {v.color.x * w, v.color.y * w, v.color.z * w, v.color.w * w}, fs);
+}
+
+// Rasterizes the part of triangle (a, b, c) inside [x0, x1) x [y0, y1).
+void rasterize_triangle(framebuffer& target, const state& state, const window_vertex* a, const window_vertex* b, const window_vertex* c, int x0, int y0, int x1, int y1, const fragment_shader& fs)
+{
+    auto area = edge(a->x, a->y, b->x, b->y, c->x, c->y);
+    if (area == 0.0f) {
+        return;
+    }
+    if (area < 0.0f) {
+        std::swap(b, c);
+        area = -area;
+    }
+
+    x0 = std::max(x0, static_cast<int>(std::floor(std::min({a->x, b->x, c->x}))));
+    y0 = std::max(y0, static_cast<int>(std::floor(std::min({a->y, b->y, c->y}))));
+    x1 = std::min(x1, static_cast<int>(std::ceil(std::max({a->x, b->x, c->x}))) + 1);
+    y1 = std::min(y1, static_cast<int>(std::ceil(std::max({a->y, b->y, c->y}))) + 1);
+
+    auto const inv_area = 1.0f / area;
+    auto const tl_a = top_left(*b, *c);
+    auto const tl_b = top_left(*c, *a);
+    auto const tl_c = top_left(*a, *b);
+    for (int y = y0; y < y1; ++y) {
+        auto const py = static_cast<float>(y) + 0.5f;
+        for (int x = x0; x < x1; ++x) {
+            auto const px = static_cast<float>(x) + 0.5f;
+            auto const wa = edge(b->x, b->y, c->x, c->y, px, py);
+            auto const wb = edge(c->x, c->y, a->x, a->y, px, py);
+            auto const wc = edge(a->x, a->y, b->x, b->y, px, py);
+            if ((wa < 0.0f || (wa == 0.0f && !tl_a)) || (wb < 0.0f || (wb == 0.0f && !tl_b)) || (wc < 0.0f || (wc == 0.0f && !tl_c))) {
+                continue;
+            }
+
+            auto const la = wa * inv_area;
+            auto const lb = wb * inv_area;
+            auto const lc = wc * inv_area;
+            auto const z = la * a->z + lb * b->z + lc * c->z;
+            auto const w = 1.0f / (la * a->inv_w + lb * b->inv_w + lc * c->inv_w);
+            auto const color = vec4{
+                w * (la * a->color.x + lb * b->color.x + lc * c->color.x),
+                w * (la * a->color.y + lb * b->color.y + lc * c->color.y),
+                w * (la * a->color.z + lb * b->color.z + lc * c->color.z),
+                w * (la * a->color.w + lb * b->color.w + lc * c->color.w)
+            };
+            auto const pixel = static_cast<std::size_t>(y) * static_cast<std::size_t>(target.width) + static_cast<std::size_t>(x);
+            write_fragment(target, state, pixel, z, color, fs);
+        }
+    }
+}
+
+// Bins the primitives of `elements` (positions in the draw, resolved to
+// shaded vertices through `vertex_of`) by tile and rasterizes the tiles.
+// Triangles reaching behind the eye are shaded again through `vs`, vertex
+// `first` + i for shaded vertex i, and clipped; the triangles left are binned
+// in their place as primitives num_primitives and up. Points behind the eye
+// are dropped.
+template <typename VertexOf>
+void rasterize(framebuffer& target, const state& state, primitive mode, const std::vector<std::uint32_t>& elements, const std::vector<window_vertex>& vertices, VertexOf vertex_of, std::size_t first, const vertex_shader& vs, const fragment_shader& fs)
+{
+    auto const grid = tile_grid{(target.width + tile_size - 1) / tile_size, (target.height + tile_size - 1) / tile_size};
+    auto const per_primitive = std::size_t{mode == primitive::points ? 1u : 3u};
+    auto const num_primitives = elements.size() / per_primitive;
+
+    auto bins = std::vector<std::vector<std::uint32_t>>(grid.size());
+    auto const bin = [&](std::uint32_t p, std::span<const window_vertex* const> corners) {
+        auto min_x = target.width;
+        auto min_y = target.height;
+        auto max_x = -1;
+        auto max_y = -1;
+        for (auto const* v : corners) {
+            min_x = std::min(min_x, static_cast<int>(std::floor(std::max(v->x, -1.0f))));
+            min_y = std::min(min_y, static_cast<int>(std::floor(std::max(v->y, -1.0f))));
+            max_x = std::max(max_x, static_cast<int>(std::floor(std::min(v->x, static_cast<float>(target.width)))));
+            max_y = std::max(max_y, static_cast<int>(std::floor(std::min(v->y, static_cast<float>(target.height)))));
+        }
+        min_x = std::max(min_x, 0);
+        min_y = std::max(min_y, 0);
+        max_x = std::min(max_x, target.width - 1);
+        max_y = std::min(max_y, target.height - 1);
+        if (min_x > max_x || min_y > max_y) {
+            return;
+        }
+        for (int ty = min_y / tile_size; ty <= max_y / tile_size; ++ty) {
+            for (int tx = min_x / tile_size; tx <= max_x / tile_size; ++tx) {
+                bins[static_cast<std::size_t>(ty * grid.columns + tx)].push_back(p);
+            }
+        }
+    };
+
+    // window vertices of the clipped triangles, three per triangle
+    auto clipped_vertices = std::vector<window_vertex>{};
+    for (std::size_t p = 0; p < num_primitives; ++p) {
+        auto const* e = elements.data() + per_primitive * p;
+        auto corners = std::array<const window_vertex*, 3>{};
+        auto clipped = false;
+        for (std::size_t k = 0; k < per_primitive; ++k) {
+            corners[k] = &vertices[vertex_of(e[k])];
+            clipped = clipped || corners[k]->clipped;
+        }
+        if (!clipped) {
+            bin(static_cast<std::uint32_t>(p), std::span{corners}.first(per_primitive));
+        } else if (mode != primitive::points) {
+            // binned right away, so tiles still draw in submission order
+            auto const begin = clipped_vertices.size();
+            clip_triangle(vs(first + vertex_of(e[0])), vs(first + vertex_of(e[1])), vs(first + vertex_of(e[2])), target.width, target.height, clipped_vertices);
+            for (auto t = begin; t < clipped_vertices.size(); t += 3) {
+                auto const triangle = std::array{&clipped_vertices[t], &clipped_vertices[t + 1], &clipped_vertices[t + 2]};
+                bin(static_cast<std::uint32_t>(num_primitives + t / 3), triangle);
+            }
+        }
+    }
+
+    parallel_for(grid.size(), state.num_threads, [&](std::size_t tile) {
+        auto const x0 = static_cast<int>(tile % static_cast<std::size_t>(grid.columns)) * tile_size;
+        auto const y0 = static_cast<int>(tile / static_cast<std::size_t>(grid.columns)) * tile_size;
+        auto const x1 = std::min(x0 + tile_size, target.width);
+        auto const y1 = std::min(y0 + tile_size, target.height);
+        for (auto p : bins[tile]) {
+            if (p >= num_primitives) {
+                auto const* v = clipped_vertices.data() + 3 * (p - num_primitives);
+                rasterize_triangle(target, state, v, v + 1, v + 2, x0, y0, x1, y1, fs);
+                continue;
+            }
+            auto const* e = elements.data() + per_primitive * p;
+            if (mode == primitive::points) {
+                rasterize_point(target, state, vertices[vertex_of(e[0])], x0, y0, x1, y1, fs);
+            } else {
+                rasterize_triangle(target, state, &vertices[vertex_of(e[0])], &vertices[vertex_of(e[1])], &vertices[vertex_of(e[2])], x0, y0, x1, y1, fs);
+            }
+        }
+    });
+}
+
+template <typename Index>
+void draw_indexed(framebuffer& target, const state& state, primitive mode, std::span<const Index> indices, const vertex_shader& vs, const fragment_shader& fs)
+{
+    if (indices.empty()) {
+        return;
+    }
+    // every vertex up to the largest index is shaded once, as a vertex cache
+    // would
+    auto const count = static_cast<std::size_t>(*std::ranges::max_element(indices)) + 1;
+    auto const vertices = shade_vertices(target, state, 0, count, vs);
+    auto const elements = assemble(mode, indices.size());
+    rasterize(target, state, mode, elements, vertices, [&](std::uint32_t i) { return static_cast<std::size_t>(indices[i]); }, 0, vs, fs);
+}
+
+} // namespace
+
+framebuffer::framebuffer(int width, int height)
+    : width{width}
+    , height{height}
+    , color(static_cast<std::size_t>(width) * static_cast<std::size_t>(height))
+    , depth(color.size(), 1.0f)
+{
+}
+
+void framebuffer::clear(rgba8 c, float d)
+{
+    std::ranges::fill(color, c);
+    std::ranges::fill(depth, d);
+}
+
+void draw_arrays(framebuffer& target, const state& state, primitive mode, std::size_t first, std::size_t count, const vertex_shader& vs, const fragment_shader& fs)
+{
+    auto const vertices = shade_vertices(target, state, first, count, vs);
+    auto const elements = assemble(mode, count);
+    rasterize(target, state, mode, elements, vertices, [](std::uint32_t i) { return static_cast<std::size_t>(i); }, first, vs, fs);
+}
+
+void draw_elements(framebuffer& target, const state& state, primitive mode, std::span<const std::uint16_t> indices, const vertex_shader& vs, const fragment_shader& fs)
+{
+    draw_indexed(target, state, mode, indices, vs, fs);
+}
+
+void draw_elements(framebuffer& target, const state& state, primitive mode, std::span<const std::uint32_t> indices, const vertex_shader& vs, const fragment_shader& fs)
+{
+    draw_indexed(target, state, mode, indices, vs, fs);
+}
+
+} // namespace icg::soft
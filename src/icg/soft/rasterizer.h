@@ -0,0 +1,81 @@
+#ifndef ICG_SOFT_RASTERIZER_H
+#define ICG_SOFT_RASTERIZER_H
+
+#include <icg/color.h>
+#include <icg/vector.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+// Software rendering of what the demos draw, for machines without a GPU. It
+// mirrors the small part of OpenGL 3.3 the demos use: points of one pixel,
+// triangles, triangle strips and fans, a depth test and one color varying,
+// with C++ callables standing in for the vertex and fragment shaders.
+// Triangles reaching behind the eye are clipped against the near plane as in
+// OpenGL; other fragments outside the depth range are discarded per pixel.
+namespace icg::soft {
+
+// Color and depth attachments of width x height pixels, rows bottom to top as
+// glReadPixels returns them.
+struct framebuffer
+{
+    framebuffer(int width, int height);
+
+    void clear(rgba8 color, float depth = 1.0f);
+
+    rgba8 pixel(int x, int y) const { return color[static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x)]; }
+
+    int width;
+    int height;
+    std::vector<rgba8> color;
+    std::vector<float> depth;
+};
+
+enum class primitive
+{
+    points,
+    triangles,
+    triangle_strip,
+    triangle_fan
+};
+
+// Output of the vertex shader: gl_Position and the color handed on to the
+// fragment shader, interpolated perspective-correctly.
+struct vertex_output
+{
+    vec4 position;
+    vec4 color;
+};
+
+// Shades vertex `index` of the draw, called once per vertex from any thread.
+using vertex_shader = std::function<vertex_output(std::size_t index)>;
+
+// Color of a fragment from its interpolated color, called from any thread.
+// An empty fragment shader writes the interpolated color as it is, like
+// gasket4.frag and cube.frag.
+using fragment_shader = std::function<vec4(const vec4& color)>;
+
+// Pixels per side of the square tiles the framebuffer is split into. The
+// primitives of a draw are binned by tile and the tiles rasterized on up to
+// num_threads threads, each tile in submission order, so the image does not
+// depend on the number of threads.
+constexpr int tile_size = 64;
+
+struct state
+{
+    bool depth_test{false};
+    unsigned num_threads{0};
+};
+
+// Like glDrawArrays: vertices [first, first + count) in order.
+void draw_arrays(framebuffer& target, const state& state, primitive mode, std::size_t first, std::size_t count, const vertex_shader& vs, const fragment_shader& fs = {});
+
+// Like glDrawElements: the vertices `indices` refer to in that order.
+void draw_elements(framebuffer& target, const state& state, primitive mode, std::span<const std::uint16_t> indices, const vertex_shader& vs, const fragment_shader& fs = {});
+void draw_elements(framebuffer& target, const state& state, primitive mode, std::span<const std::uint32_t> indices, const vertex_shader& vs, const fragment_shader& fs = {});
+
+} // namespace icg::soft
+
+#endif // ICG_SOFT_RASTERIZER_H
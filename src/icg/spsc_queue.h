@@ -0,0 +1,74 @@
+#ifndef ICG_SPSC_QUEUE_H
+#define ICG_SPSC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace icg {
+
+// Bounded lock-free queue between exactly one producer thread and one consumer
+// thread. Neither side ever blocks: try_push fails when the queue is full and
+// try_pop when it is empty. The two indices live on cache lines of their own,
+// so the threads only share a line when one hands an element to the other.
+template <typename T>
+class spsc_queue
+{
+public:
+    // The capacity is rounded up to a power of two.
+    explicit spsc_queue(std::size_t capacity)
+        : slots(std::bit_ceil(std::max<std::size_t>(capacity, 1)))
+        , mask{slots.size() - 1}
+    {
+    }
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    std::size_t capacity() const { return slots.size(); }
+
+    // Producer side.
+    bool try_push(T value)
+    {
+        auto const t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == slots.size()) {
+            return false;
+        }
+        slots[t & mask] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side.
+    std::optional<T> try_pop()
+    {
+        auto const h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        auto value = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return value;
+    }
+
+    // Only a snapshot while the other side is running.
+    bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+
+private:
+    static constexpr std::size_t cache_line = 64;
+
+    std::vector<T> slots;
+    std::size_t mask;
+    // next element to pop, written by the consumer only
+    alignas(cache_line) std::atomic<std::size_t> head{0};
+    // next slot to push into, written by the producer only
+    alignas(cache_line) std::atomic<std::size_t> tail{0};
+};
+
+} // namespace icg
+
+#endif // ICG_SPSC_QUEUE_H
@@ -0,0 +1,294 @@
+#include "subdivision.h"
+#include "parallel.h"
+#include <cassert>
+#include <limits>
+
+namespace icg {
+
+namespace {
+
+// Below this many levels a subdivision is not worth spreading over threads.
+constexpr int min_parallel_count = 6;
+
+// Levels subdivided serially before the subtrees are handed out to threads,
+// which leaves 3^3 = 27 or 4^3 = 64 subtrees to balance the load.
+constexpr int parallel_split_count = 3;
+
+// Replaces each of the first `num_triangles` triangles, stored three vertices
+// apiece, by its three children, `levels` times over. Triangle i is expanded
+// into triangles 3i, 3i + 1 and 3i + 2, so walking backwards never overwrites
+// a triangle that is still to be read, and the final order is the one of the
+// recursive depth-first subdivision.
+void expand_triangles(vec2* positions, std::size_t num_triangles, int levels)
+{
+    for (int level = 0; level < levels; ++level, num_triangles *= 3) {
+        for (auto i = num_triangles; i-- > 0;) {
+            auto const a = positions[3 * i];
+            auto const b = positions[3 * i + 1];
+            auto const c = positions[3 * i + 2];
+
+            // bisect the sides
+            auto const ab = 0.5f * (a + b);
+            auto const ac = 0.5f * (a + c);
+            auto const bc = 0.5f * (b + c);
+
+            // three new triangles
+            auto* out = positions + 9 * i;
+            out[0] = a;  out[1] = ab; out[2] = ac;
+            out[3] = c;  out[4] = ac; out[5] = bc;
+            out[6] = b;  out[7] = bc; out[8] = ab;
+        }
+    }
+}
+
+// Same for tetrahedra, stored four corners apiece.
+void expand_tetrahedra(vec3* corners, std::size_t num_tetrahedra, int levels)
+{
+    for (int level = 0; level < levels; ++level, num_tetrahedra *= 4) {
+        for (auto i = num_tetrahedra; i-- > 0;) {
+            auto const a = corners[4 * i];
+            auto const b = corners[4 * i + 1];
+            auto const c = corners[4 * i + 2];
+            auto const d = corners[4 * i + 3];
+
+            // find midpoints of sides, divide four smaller tetrahedra
+            auto const ab = 0.5f * (a + b);
+            auto const ac = 0.5f * (a + c);
+            auto const ad = 0.5f * (a + d);
+            auto const bc = 0.5f * (b + c);
+            auto const bd = 0.5f * (b + d);
+            auto const cd = 0.5f * (c + d);
+
+            auto* out = corners + 16 * i;
+            out[0]  = a;  out[1]  = ab; out[2]  = ac; out[3]  = ad;
+            out[4]  = ab; out[5]  = b;  out[6]  = bc; out[7]  = bd;
+            out[8]  = ac; out[9]  = bc; out[10] = c;  out[11] = cd;
+            out[12] = ad; out[13] = bd; out[14] = cd; out[15] = d;
+        }
+    }
+}
+
+// Turns tetrahedra stored four corners apiece into their four triangles,
+// twelve vertices apiece, in place.
+void emit_tetrahedra(vec3* positions, std::size_t num_tetrahedra)
+{
+    for (auto i = num_tetrahedra; i-- > 0;) {
+        auto const a = positions[4 * i];
+        auto const b = positions[4 * i + 1];
+        auto const c = positions[4 * i + 2];
+        auto const d = positions[4 * i + 3];
+
+        // tetrahedron with each side using a different color
+        auto* out = positions + 12 * i;
+        out[0] = a; out[1]  = c; out[2]  = b;
+        out[3] = a; out[4]  = c; out[5]  = d;
+        out[6] = a; out[7]  = b; out[8]  = d;
+        out[9] = b; out[10] = c; out[11] = d;
+    }
+}
+
+// Moves the first `count` items of `stride` elements each so that item i
+// starts at element i * spacing, walking backwards to not clobber any of them.
+template <typename T>
+void spread(T* items, std::size_t count, std::size_t stride, std::size_t spacing)
+{
+    for (auto i = count; i-- > 1;) {
+        for (auto k = stride; k-- > 0;) {
+            items[i * spacing + k] = items[i * stride + k];
+        }
+    }
+}
+
+// Appends the midpoint of points u and v and returns its id. The simplices of
+// a gasket share corners but never edges, so every edge is split by exactly
+// one parent and its midpoint is added once without looking it up; the
+// children get it from the parent as one of their corners.
+template <typename Vec>
+std::uint32_t add_midpoint(std::vector<Vec>& points, std::uint32_t u, std::uint32_t v)
+{
+    points.push_back(0.5f * (points[u] + points[v]));
+    return static_cast<std::uint32_t>(points.size() - 1);
+}
+
+// Narrows the indices to 16 bit when every vertex can be addressed with them.
+template <typename Vec>
+void set_indices(indexed_triangles<Vec>& mesh, std::vector<std::uint32_t>&& indices)
+{
+    if (mesh.num_vertices() <= std::size_t{std::numeric_limits<std::uint16_t>::max()} + 1) {
+        mesh.indices = std::vector<std::uint16_t>(indices.begin(), indices.end());
+    } else {
+        mesh.indices = std::move(indices);
+    }
+}
+
+} // namespace
+
+void divide_triangle(const vec2& a, const vec2& b, const vec2& c, int count, std::span<vec2> positions, unsigned num_threads)
+{
+    assert(positions.size() == divide_triangle_size(count));
+
+    positions[0] = a;
+    positions[1] = b;
+    positions[2] = c;
+
+    if (count < min_parallel_count || resolve_num_threads(num_threads) == 1) {
+        expand_triangles(positions.data(), 1, count);
+        return;
+    }
+
+    auto const num_subtrees = divide_triangle_size(parallel_split_count) / 3;
+    auto const subtree_size = divide_triangle_size(count - parallel_split_count);
+    expand_triangles(positions.data(), 1, parallel_split_count);
+    spread(positions.data(), num_subtrees, 3, subtree_size);
+    parallel_for(num_subtrees, num_threads, [&](std::size_t i) {
+        expand_triangles(positions.data() + i * subtree_size, 1, count - parallel_split_count);
+    });
+}
+
+std::vector<vec2> divide_triangle(const vec2& a, const vec2& b, const vec2& c, int count, unsigned num_threads)
+{
+    auto positions = std::vector<vec2>(divide_triangle_size(count));
+    divide_triangle(a, b, c, count, positions, num_threads);
+    return positions;
+}
+
+void divide_tetra(const vec3& a, const vec3& b, const vec3& c, const vec3& d, int count, std::span<vec3> positions, std::span<vec3> colors, unsigned num_threads)
+{
+    assert(positions.size() == divide_tetra_size(count));
+    assert(colors.size() == divide_tetra_size(count));
+
+    positions[0] = a;
+    positions[1] = b;
+    positions[2] = c;
+    positions[3] = d;
+
+    auto fill_colors = [&](std::size_t first, std::size_t last) {
+        for (auto i = first; i < last; i += 3) {
+            colors[i] = colors[i + 1] = colors[i + 2] = tetra_face_colors[(i / 3) % 4];
+        }
+    };
+
+    if (count < min_parallel_count || resolve_num_threads(num_threads) == 1) {
+        expand_tetrahedra(positions.data(), 1, count);
+        emit_tetrahedra(positions.data(), positions.size() / 12);
+        fill_colors(0, colors.size());
+        return;
+    }
+
+    auto const num_subtrees = divide_tetra_size(parallel_split_count) / 12;
+    auto const subtree_size = divide_tetra_size(count - parallel_split_count);
+    expand_tetrahedra(positions.data(), 1, parallel_split_count);
+    spread(positions.data(), num_subtrees, 4, subtree_size);
+    parallel_for(num_subtrees, num_threads, [&](std::size_t i) {
+        auto* subtree = positions.data() + i * subtree_size;
+        expand_tetrahedra(subtree, 1, count - parallel_split_count);
+        emit_tetrahedra(subtree, subtree_size / 12);
+        fill_colors(i * subtree_size, (i + 1) * subtree_size);
+    });
+}
+
+colored_triangles divide_tetra(const vec3& a, const vec3& b, const vec3& c, const vec3& d, int count, unsigned num_threads)
+{
+    auto mesh = colored_triangles{
+        std::vector<vec3>(divide_tetra_size(count)),
+        std::vector<vec3>(divide_tetra_size(count))
+    };
+    divide_tetra(a, b, c, d, count, mesh.positions, mesh.colors, num_threads);
+    return mesh;
+}
+
+indexed_triangles<vec2> divide_triangle_indexed(const vec2& a, const vec2& b, const vec2& c, int count)
+{
+    auto mesh = indexed_triangles<vec2>{};
+    mesh.positions = {a, b, c};
+    // each triangle split adds three midpoints, one per side
+    mesh.positions.reserve(3 + 3 * (divide_triangle_size(count) / 3 - 1) / 2);
+    auto midpoint = [&](std::uint32_t u, std::uint32_t v) { return add_midpoint(mesh.positions, u, v); };
+
+    // Same level by level expansion as expand_triangles, on vertex ids.
+    auto triangles = std::vector<std::uint32_t>(divide_triangle_size(count));
+    triangles[0] = 0;
+    triangles[1] = 1;
+    triangles[2] = 2;
+    for (std::size_t level = 0, n = 1; level < static_cast<std::size_t>(count); ++level, n *= 3) {
+        for (auto i = n; i-- > 0;) {
+            auto const va = triangles[3 * i];
+            auto const vb = triangles[3 * i + 1];
+            auto const vc = triangles[3 * i + 2];
+            auto const ab = midpoint(va, vb);
+            auto const ac = midpoint(va, vc);
+            auto const bc = midpoint(vb, vc);
+            auto* out = triangles.data() + 9 * i;
+            out[0] = va; out[1] = ab; out[2] = ac;
+            out[3] = vc; out[4] = ac; out[5] = bc;
+            out[6] = vb; out[7] = bc; out[8] = ab;
+        }
+    }
+
+    set_indices(mesh, std::move(triangles));
+    return mesh;
+}
+
+indexed_triangles<vec3> divide_tetra_indexed(const vec3& a, const vec3& b, const vec3& c, const vec3& d, int count)
+{
+    auto points = std::vector<vec3>{a, b, c, d};
+    // each tetrahedron split adds six midpoints, one per edge
+    points.reserve(4 + 6 * (divide_tetra_size(count) / 12 - 1) / 3);
+    auto midpoint = [&](std::uint32_t u, std::uint32_t v) { return add_midpoint(points, u, v); };
+
+    // Same level by level expansion as expand_tetrahedra, on vertex ids.
+    auto tetrahedra = std::vector<std::uint32_t>(divide_tetra_size(count) / 3);
+    for (std::uint32_t k = 0; k < 4; ++k) {
+        tetrahedra[k] = k;
+    }
+    for (std::size_t level = 0, n = 1; level < static_cast<std::size_t>(count); ++level, n *= 4) {
+        for (auto i = n; i-- > 0;) {
+            auto const va = tetrahedra[4 * i];
+            auto const vb = tetrahedra[4 * i + 1];
+            auto const vc = tetrahedra[4 * i + 2];
+            auto const vd = tetrahedra[4 * i + 3];
+            auto const ab = midpoint(va, vb);
+            auto const ac = midpoint(va, vc);
+            auto const ad = midpoint(va, vd);
+            auto const bc = midpoint(vb, vc);
+            auto const bd = midpoint(vb, vd);
+            auto const cd = midpoint(vc, vd);
+            auto* out = tetrahedra.data() + 16 * i;
+            out[0]  = va; out[1]  = ab; out[2]  = ac; out[3]  = ad;
+            out[4]  = ab; out[5]  = vb; out[6]  = bc; out[7]  = bd;
+            out[8]  = ac; out[9]  = bc; out[10] = vc; out[11] = cd;
+            out[12] = ad; out[13] = bd; out[14] = cd; out[15] = vd;
+        }
+    }
+
+    // A point shared by faces of different colors needs one vertex per color.
+    constexpr auto unassigned = std::numeric_limits<std::uint32_t>::max();
+    auto vertex_of = std::vector<std::uint32_t>(4 * points.size(), unassigned);
+    auto mesh = indexed_triangles<vec3>{};
+    auto indices = std::vector<std::uint32_t>(divide_tetra_size(count));
+    auto emit = [&](std::size_t slot, std::uint32_t point, std::size_t color) {
+        auto& vertex = vertex_of[4 * point + color];
+        if (vertex == unassigned) {
+            vertex = static_cast<std::uint32_t>(mesh.positions.size());
+            mesh.positions.push_back(points[point]);
+            mesh.colors.push_back(tetra_face_colors[color]);
+        }
+        indices[slot] = vertex;
+    };
+    for (std::size_t i = 0; i < tetrahedra.size() / 4; ++i) {
+        auto const va = tetrahedra[4 * i];
+        auto const vb = tetrahedra[4 * i + 1];
+        auto const vc = tetrahedra[4 * i + 2];
+        auto const vd = tetrahedra[4 * i + 3];
+        auto const slot = 12 * i;
+        emit(slot,     va, 0); emit(slot + 1,  vc, 0); emit(slot + 2,  vb, 0);
+        emit(slot + 3, va, 1); emit(slot + 4,  vc, 1); emit(slot + 5,  vd, 1);
+        emit(slot + 6, va, 2); emit(slot + 7,  vb, 2); emit(slot + 8,  vd, 2);
+        emit(slot + 9, vb, 3); emit(slot + 10, vc, 3); emit(slot + 11, vd, 3);
+    }
+
+    set_indices(mesh, std::move(indices));
+    return mesh;
+}
+
+} // namespace icg
@@ -0,0 +1,81 @@
+#ifndef ICG_SUBDIVISION_H
+#define ICG_SUBDIVISION_H
+
+#include "indexed_mesh.h"
+#include "vector.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace icg {
+
+// Face colors of each tetrahedron produced by divide_tetra.
+constexpr auto tetra_face_colors = std::array {
+    vec3{1.0f, 0.0f, 0.0f},
+    vec3{0.0f, 1.0f, 0.0f},
+    vec3{0.0f, 0.0f, 1.0f},
+    vec3{0.0f, 0.0f, 0.0f}
+};
+
+struct colored_triangles
+{
+    std::vector<vec3> positions;
+    std::vector<vec3> colors;
+};
+
+// Number of vertices produced by divide_triangle: three for each of the 3^count triangles.
+constexpr std::size_t divide_triangle_size(int count)
+{
+    auto size = std::size_t{3};
+    for (int i = 0; i < count; ++i) {
+        size *= 3;
+    }
+    return size;
+}
+
+// Number of vertices produced by divide_tetra: twelve for each of the 4^count tetrahedra.
+constexpr std::size_t divide_tetra_size(int count)
+{
+    auto size = std::size_t{12};
+    for (int i = 0; i < count; ++i) {
+        size *= 4;
+    }
+    return size;
+}
+
+// Bisects the sides of a triangle `count` times and writes the vertices of the
+// remaining triangles, three per triangle, into `positions`, which must hold
+// exactly divide_triangle_size(count) elements. The triangles are produced
+// level by level in place rather than recursively; once there are enough of
+// them, the subtrees are finished on up to `num_threads` threads (0 uses all
+// cores). The result does not depend on the number of threads.
+void divide_triangle(const vec2& a, const vec2& b, const vec2& c, int count, std::span<vec2> positions, unsigned num_threads = 0);
+std::vector<vec2> divide_triangle(const vec2& a, const vec2& b, const vec2& c, int count, unsigned num_threads = 0);
+
+// Divides a tetrahedron `count` times and writes the triangles of the remaining
+// tetrahedra into `positions` and `colors`, each side colored with one of
+// tetra_face_colors. Both must hold exactly divide_tetra_size(count) elements.
+// Works like divide_triangle otherwise.
+void divide_tetra(const vec3& a, const vec3& b, const vec3& c, const vec3& d, int count, std::span<vec3> positions, std::span<vec3> colors, unsigned num_threads = 0);
+colored_triangles divide_tetra(const vec3& a, const vec3& b, const vec3& c, const vec3& d, int count, unsigned num_threads = 0);
+
+// Versions of the output of divide_triangle and divide_tetra_indexed for a
+// geometry_key, bumped whenever it changes for the same arguments.
+constexpr std::uint32_t divide_triangle_version = 1;
+constexpr std::uint32_t divide_tetra_indexed_version = 1;
+
+// Indexed versions of divide_triangle and divide_tetra, for glDrawElements.
+// They store every distinct vertex once: the midpoint of an edge is added by
+// the one simplex that splits it, and in 3D once per face color it takes.
+// They run on a single thread, far slower than the flat versions. In 2D the
+// triangles only share corners, so once 32-bit indices are needed these cost
+// as much as the vertices they save (see mesh_reduction::saves); gasket2
+// draws divide_triangle as it is.
+indexed_triangles<vec2> divide_triangle_indexed(const vec2& a, const vec2& b, const vec2& c, int count);
+indexed_triangles<vec3> divide_tetra_indexed(const vec3& a, const vec3& b, const vec3& c, const vec3& d, int count);
+
+} // namespace icg
+
+#endif // ICG_SUBDIVISION_H
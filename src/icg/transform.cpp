@@ -0,0 +1,119 @@
+#include "transform.h"
+#include <cmath>
+#include <numbers>
+
+#if defined(__SSE__) || defined(_M_X64)
+#define ICG_SSE_TRANSFORM
+#include <xmmintrin.h>
+#endif
+
+namespace icg {
+
+sin_cos fast_sincos(float radians)
+{
+    // x = quadrant * pi/2 + r with |r| <= pi/4, pi/2 split in three parts so
+    // that subtracting quadrant * pi/2 stays exact (Cody and Waite)
+    auto const quadrant = std::nearbyint(radians * std::numbers::inv_pi_v<float> * 2.0f);
+    auto r = radians;
+    r -= quadrant * 1.5703125f;
+    r -= quadrant * 4.837512969970703125e-4f;
+    r -= quadrant * 7.54978995489188216e-8f;
+
+    // minimax polynomials on [-pi/4, pi/4] (Cephes sinf/cosf)
+    auto const r2 = r * r;
+    auto const s = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    auto const c = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+    switch (static_cast<long>(quadrant) & 3) {
+        case 0:
+            return {s, c};
+        case 1:
+            return {c, -s};
+        case 2:
+            return {-s, -c};
+        default:
+            return {-c, s};
+    }
+}
+
+mat4 operator*(const mat4& a, const mat4& b)
+{
+    auto result = mat4{};
+#ifdef ICG_SSE_TRANSFORM
+    // column c of the product is a combination of the columns of a weighted
+    // by the elements of column c of b
+    __m128 columns[4];
+    for (int c = 0; c < 4; ++c) {
+        columns[c] = _mm_load_ps(a.m + 4 * c);
+    }
+    for (int c = 0; c < 4; ++c) {
+        auto sum = _mm_mul_ps(columns[0], _mm_set1_ps(b.m[4 * c]));
+        sum = _mm_add_ps(sum, _mm_mul_ps(columns[1], _mm_set1_ps(b.m[4 * c + 1])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(columns[2], _mm_set1_ps(b.m[4 * c + 2])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(columns[3], _mm_set1_ps(b.m[4 * c + 3])));
+        _mm_store_ps(result.m + 4 * c, sum);
+    }
+#else
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            auto sum = 0.0f;
+            for (int k = 0; k < 4; ++k) {
+                sum += a.m[4 * k + r] * b.m[4 * c + k];
+            }
+            result.m[4 * c + r] = sum;
+        }
+    }
+#endif
+    return result;
+}
+
+mat4 scale(const vec3& s)
+{
+    return {{
+        s.x,  0.0f, 0.0f, 0.0f,
+        0.0f, s.y,  0.0f, 0.0f,
+        0.0f, 0.0f, s.z,  0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    }};
+}
+
+mat4 rotation(const vec3& theta)
+{
+    constexpr auto to_radians = std::numbers::pi_v<float> / 180.0f;
+    auto const x = fast_sincos(to_radians * theta.x);
+    auto const y = fast_sincos(to_radians * theta.y);
+    auto const z = fast_sincos(to_radians * theta.z);
+
+    auto const rx = mat4{{
+        1.0f,  0.0f,  0.0f,  0.0f,
+        0.0f,  x.cos, x.sin, 0.0f,
+        0.0f, -x.sin, x.cos, 0.0f,
+        0.0f,  0.0f,  0.0f,  1.0f
+    }};
+    auto const ry = mat4{{
+        y.cos, 0.0f, -y.sin, 0.0f,
+        0.0f,  1.0f,  0.0f,  0.0f,
+        y.sin, 0.0f,  y.cos, 0.0f,
+        0.0f,  0.0f,  0.0f,  1.0f
+    }};
+    auto const rz = mat4{{
+         z.cos, z.sin, 0.0f, 0.0f,
+        -z.sin, z.cos, 0.0f, 0.0f,
+         0.0f,  0.0f,  1.0f, 0.0f,
+         0.0f,  0.0f,  0.0f, 1.0f
+    }};
+    return rz * ry * rx;
+}
+
+vec4 operator*(const mat4& a, const vec4& v)
+{
+    auto const& m = a.m;
+    return {
+        m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
+        m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
+        m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w,
+        m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w
+    };
+}
+
+} // namespace icg
@@ -0,0 +1,42 @@
+#ifndef ICG_TRANSFORM_H
+#define ICG_TRANSFORM_H
+
+#include "vector.h"
+
+namespace icg {
+
+// Column-major 4x4 matrix, laid out as glUniformMatrix4fv expects it with
+// transpose = GL_FALSE: element (row r, column c) is m[4 * c + r].
+struct alignas(16) mat4
+{
+    float m[16];
+
+    const float* data() const { return m; }
+    float operator()(int row, int column) const { return m[4 * column + row]; }
+};
+
+struct sin_cos
+{
+    float sin;
+    float cos;
+};
+
+// Sine and cosine of `radians` from a single range reduction and two short
+// polynomials, within 1e-7 of std::sin/std::cos for |radians| < 10^4.
+sin_cos fast_sincos(float radians);
+
+// Product a * b, four columns at a time with SSE on x86.
+mat4 operator*(const mat4& a, const mat4& b);
+
+mat4 scale(const vec3& s);
+
+// Rotation by theta.x, theta.y and theta.z degrees about the x, y and z axes,
+// applied in that order: rz * ry * rx, as cube.vert used to build it for
+// every vertex.
+mat4 rotation(const vec3& theta);
+
+vec4 operator*(const mat4& a, const vec4& v);
+
+} // namespace icg
+
+#endif // ICG_TRANSFORM_H
@@ -0,0 +1,54 @@
+#include "uniform_shadow.h"
+#include <algorithm>
+#include <cstring>
+
+namespace icg {
+
+void uniform_shadow::clear()
+{
+    slots.clear();
+    values.clear();
+    num_declared = 0;
+}
+
+void uniform_shadow::declare(int location, std::size_t size)
+{
+    if (location < 0) {
+        return;
+    }
+    auto const index = static_cast<std::size_t>(location);
+    if (index >= slots.size()) {
+        slots.resize(index + 1);
+    }
+    if (slots[index].size == 0) {
+        ++num_declared;
+    }
+    slots[index] = {values.size(), size, false};
+    values.resize(values.size() + size);
+}
+
+bool uniform_shadow::update(int location, std::span<const std::byte> value)
+{
+    if (location < 0) {
+        ++counts.skipped;
+        return false;
+    }
+    auto const index = static_cast<std::size_t>(location);
+    if (index >= slots.size() || value.size() > slots[index].size) {
+        ++counts.issued;
+        return true;
+    }
+
+    auto& s = slots[index];
+    auto const stored = values.data() + s.offset;
+    if (s.known && std::memcmp(stored, value.data(), value.size()) == 0) {
+        ++counts.skipped;
+        return false;
+    }
+    std::ranges::copy(value, stored);
+    s.known = true;
+    ++counts.issued;
+    return true;
+}
+
+} // namespace icg
@@ -0,0 +1,62 @@
+#ifndef ICG_UNIFORM_SHADOW_H
+#define ICG_UNIFORM_SHADOW_H
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace icg {
+
+// Uniform uploads that went to the driver and that were skipped because the
+// value had not changed.
+struct uniform_stats
+{
+    std::size_t issued{0};
+    std::size_t skipped{0};
+};
+
+// Copy of the last value uploaded to each uniform location of a program, so
+// that setting a uniform to the value it already has costs a compare rather
+// than a call into the driver. Locations are declared after linking with the
+// size of their type; values of undeclared locations are never cached.
+class uniform_shadow
+{
+public:
+    // Forgets all locations and values, e.g. before relinking.
+    void clear();
+
+    void declare(int location, std::size_t size);
+
+    // Whether `value` has to be uploaded to `location`, i.e. differs from the
+    // last value stored there, which it then replaces. Location -1, which GL
+    // silently ignores, never has to be.
+    bool update(int location, std::span<const std::byte> value);
+
+    template <typename T>
+    bool update(int location, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return update(location, std::as_bytes(std::span{&value, 1}));
+    }
+
+    std::size_t size() const { return num_declared; }
+    const uniform_stats& stats() const { return counts; }
+
+private:
+    struct slot
+    {
+        std::size_t offset{0};
+        std::size_t size{0};
+        bool known{false};
+    };
+
+    std::vector<slot> slots;
+    std::vector<std::byte> values;
+    std::size_t num_declared{0};
+    uniform_stats counts;
+};
+
+} // namespace icg
+
+#endif // ICG_UNIFORM_SHADOW_H
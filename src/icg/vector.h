@@ -0,0 +1,46 @@
+#ifndef ICG_VECTOR_H
+#define ICG_VECTOR_H
+
+namespace icg {
+
+// Plain float vectors with the same memory layout as tinyla::vec2f/vec3f/vec4f,
+// so the geometry produced here can be handed to tinygl::buffer::create as is
+// while the library itself stays free of any OpenGL dependency.
+
+struct vec2
+{
+    float x;
+    float y;
+};
+
+struct vec3
+{
+    float x;
+    float y;
+    float z;
+};
+
+struct vec4
+{
+    float x;
+    float y;
+    float z;
+    float w;
+};
+
+static_assert(sizeof(vec2) == 2 * sizeof(float));
+static_assert(sizeof(vec3) == 3 * sizeof(float));
+static_assert(sizeof(vec4) == 4 * sizeof(float));
+
+constexpr vec2 operator+(const vec2& a, const vec2& b) { return {a.x + b.x, a.y + b.y}; }
+constexpr vec3 operator+(const vec3& a, const vec3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+
+constexpr vec2 operator*(float s, const vec2& v) { return {s * v.x, s * v.y}; }
+constexpr vec3 operator*(float s, const vec3& v) { return {s * v.x, s * v.y, s * v.z}; }
+
+constexpr bool operator==(const vec2& a, const vec2& b) { return a.x == b.x && a.y == b.y; }
+constexpr bool operator==(const vec3& a, const vec3& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+
+} // namespace icg
+
+#endif // ICG_VECTOR_H
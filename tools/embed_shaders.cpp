@@ -0,0 +1,102 @@
+// Build step that compiles the shaders of a chapter into its demos: writes a
+// header defining an icg::shader_source shaders::<file name> for every shader
+// given, preprocessed with icg::preprocess_shader.
+//
+//     embed_shaders OUTPUT [-DNAME[=VALUE]]... SHADER...
+//
+// The header is only rewritten if its contents change, so that touching a
+// shader without changing it recompiles nothing.
+
+#include <icg/shader_source.h>
+#include <fmt/core.h>
+#include <cctype>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view delimiter = "glsl";
+
+// gasket1.vert -> gasket1_vert
+std::string identifier(const std::filesystem::path& path)
+{
+    auto name = path.filename().string();
+    for (auto& c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c))) {
+            c = '_';
+        }
+    }
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name.front()))) {
+        name = "_" + name;
+    }
+    return name;
+}
+
+std::string read(const std::filesystem::path& path)
+{
+    auto file = std::ifstream{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file}, {}};
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        fmt::print(stderr, "usage: {} OUTPUT [-DNAME[=VALUE]]... SHADER...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        auto const output = std::filesystem::path{argv[1]};
+        auto defines = std::vector<icg::shader_define>{};
+        auto shaders = std::vector<std::filesystem::path>{};
+        for (int i = 2; i < argc; ++i) {
+            auto const arg = std::string_view{argv[i]};
+            if (arg.starts_with("-D")) {
+                auto const define = arg.substr(2);
+                auto const equals = define.find('=');
+                defines.push_back({std::string{define.substr(0, equals)},
+                    equals == std::string_view::npos ? std::string{} : std::string{define.substr(equals + 1)}});
+            } else {
+                shaders.emplace_back(arg);
+            }
+        }
+
+        auto header = std::string{"// Generated by embed_shaders, do not edit.\n\n"
+            "#ifndef ICG_EMBEDDED_SHADERS_H\n#define ICG_EMBEDDED_SHADERS_H\n\n"
+            "#include <icg/shader_source.h>\n\nnamespace shaders {\n"};
+        for (auto const& shader : shaders) {
+            auto const text = icg::preprocess_shader_file(shader, defines);
+            if (text.find(fmt::format("){}\"", delimiter)) != std::string::npos) {
+                throw std::runtime_error{shader.string() + " contains the raw string delimiter"};
+            }
+            header += fmt::format("\ninline constexpr icg::shader_source {}{{\"{}\", R\"{}({}){}\"}};\n",
+                identifier(shader), shader.filename().string(), delimiter, text, delimiter);
+        }
+        header += "\n} // namespace shaders\n\n#endif // ICG_EMBEDDED_SHADERS_H\n";
+
+        if (!std::filesystem::exists(output) || read(output) != header) {
+            if (output.has_parent_path()) {
+                std::filesystem::create_directories(output.parent_path());
+            }
+            auto file = std::ofstream{output, std::ios::binary | std::ios::trunc};
+            file << header;
+            if (!file) {
+                throw std::runtime_error{"Cannot write " + output.string()};
+            }
+        }
+    } catch (const std::exception& e) {
+        fmt::print(stderr, "{}\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}